@@ -19,402 +19,4254 @@ extern "C"
 }
 
 #include <algorithm>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <cerrno>
+#include <climits>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <fstream>
+#include <list>
+#include <memory>
+#include <memory_resource>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define JSON_USE_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define JSON_USE_NEON 1
+#endif
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <process.h>
+#include <sys/stat.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 static constexpr const char *GLAZE_VERSION_STRING = "7.0.1";
 
+// Ring has no boolean type and no way to tell an empty object from an empty
+// list, so these strings stand in for them (null is the empty string). They
+// are matched by length first, so ordinary strings cost one comparison.
+static constexpr char JSON_TRUE_MARKER[] = "__JSON_TRUE__";
+static constexpr char JSON_FALSE_MARKER[] = "__JSON_FALSE__";
+static constexpr char JSON_EMPTY_OBJECT_MARKER[] = "__JSON_EMPTY_OBJECT__";
+
+template <size_t N> static inline bool json_is_marker(const char *cString, size_t nSize, const char (&cMarker)[N])
+{
+	return nSize == N - 1 && memcmp(cString, cMarker, N - 1) == 0;
+}
+
 #define IS_JSON_EMPTY_OBJECT(pList)                                                                                    \
 	(ring_list_getsize(pList) == 1 && ring_list_isstring(pList, 1) &&                                                  \
-	 strcmp(ring_list_getstring(pList, 1), "__JSON_EMPTY_OBJECT__") == 0)
+	 json_is_marker(ring_list_getstring(pList, 1), ring_list_getstringsize(pList, 1), JSON_EMPTY_OBJECT_MARKER))
 
-static glz::generic ring_item_to_json_value(VM *pVM, Item *pItem, List *pVisited);
-static glz::generic ring_list_to_json_value(VM *pVM, List *pList, List *pVisited);
 
-static void json_value_to_ring_item(void *pState, const glz::generic &value, List *pList)
+// String parameter nParam as a view of the whole Ring string. Taking the size
+// from Ring avoids a strlen and keeps embedded NULs; Ring also keeps a NUL
+// after the last byte, which glaze relies on when it reads from a view.
+#define JSON_STRING_PARAM(nParam) std::string_view(RING_API_GETSTRING(nParam), RING_API_GETSTRINGSIZE(nParam))
+
+// Non-negative number parameter as a size, saturated at SIZE_MAX
+static size_t json_size_from_number(double nValue)
 {
-	if (auto *obj = value.get_if<glz::generic::object_t>())
+	return nValue >= (double)SIZE_MAX ? SIZE_MAX : (size_t)nValue;
+}
+
+// Buffers kept for reuse per thread, and the largest capacity worth keeping
+constexpr size_t JSON_BUFFER_POOL_SIZE = 4;
+constexpr size_t JSON_BUFFER_KEEP_MAX = 4 * 1024 * 1024;
+
+// Output string borrowed from a per-thread pool for the duration of a call.
+// The pool holds the buffers of earlier calls with their capacity intact, so
+// repeated serialization of similar sized results does not allocate.
+class json_output_buffer
+{
+  public:
+	json_output_buffer()
 	{
-		List *pObjectList = ring_list_newlist_gc(pState, pList);
-		for (const auto &[key, val] : *obj)
+		auto &aPool = pool();
+		if (!aPool.empty())
 		{
-			List *pItemList = ring_list_newlist_gc(pState, pObjectList);
-			ring_list_addstring_gc(pState, pItemList, key.c_str());
-			json_value_to_ring_item(pState, val, pItemList);
+			cBuffer = std::move(aPool.back());
+			aPool.pop_back();
 		}
 	}
-	else if (auto *arr = value.get_if<glz::generic::array_t>())
+
+	~json_output_buffer()
 	{
-		List *pArrayList = ring_list_newlist_gc(pState, pList);
-		for (const auto &val : *arr)
+		auto &aPool = pool();
+		if (aPool.size() < JSON_BUFFER_POOL_SIZE && cBuffer.capacity() <= JSON_BUFFER_KEEP_MAX)
 		{
-			json_value_to_ring_item(pState, val, pArrayList);
+			cBuffer.clear();
+			aPool.push_back(std::move(cBuffer));
 		}
 	}
-	else if (auto *str = value.get_if<std::string>())
+
+	json_output_buffer(const json_output_buffer &) = delete;
+	json_output_buffer &operator=(const json_output_buffer &) = delete;
+
+	std::string &str()
 	{
-		ring_list_addstring_gc(pState, pList, str->c_str());
+		return cBuffer;
 	}
-	else if (auto *num = value.get_if<double>())
+
+  private:
+	std::string cBuffer;
+
+	static std::vector<std::string> &pool()
 	{
-		ring_list_adddouble_gc(pState, pList, *num);
+		static thread_local std::vector<std::string> aPool;
+		return aPool;
 	}
-	else if (auto *b = value.get_if<bool>())
+};
+
+// Arena blocks, the largest request served from a block, and the block memory
+// an arena keeps between calls
+constexpr size_t JSON_ARENA_BLOCK_SIZE = 64 * 1024;
+constexpr size_t JSON_ARENA_LARGE_MIN = JSON_ARENA_BLOCK_SIZE / 4;
+constexpr size_t JSON_ARENA_KEEP_MAX = 4 * 1024 * 1024;
+
+// Bump allocator for the temporary trees of one call. Deallocation is a no-op;
+// reset() releases everything at once and rewinds to the first block, keeping
+// the blocks for the next call. Requests too large for a block get their own
+// allocation, released on reset().
+class json_arena_resource : public std::pmr::memory_resource
+{
+  public:
+	json_arena_resource() = default;
+	json_arena_resource(const json_arena_resource &) = delete;
+	json_arena_resource &operator=(const json_arena_resource &) = delete;
+
+	~json_arena_resource() override
 	{
-		ring_list_addstring_gc(pState, pList, *b ? "__JSON_TRUE__" : "__JSON_FALSE__");
+		reset();
+		for (char *pBlock : aBlocks)
+		{
+			::operator delete(pBlock);
+		}
 	}
-	else
+
+	void reset()
 	{
-		ring_list_addstring_gc(pState, pList, RING_CSTR_EMPTY);
+		for (const auto &[pData, nAlign] : aLarge)
+		{
+			::operator delete(pData, std::align_val_t(nAlign));
+		}
+		aLarge.clear();
+		while (aBlocks.size() * JSON_ARENA_BLOCK_SIZE > JSON_ARENA_KEEP_MAX)
+		{
+			::operator delete(aBlocks.back());
+			aBlocks.pop_back();
+		}
+		nUsed = 0;
+		pCursor = pLimit = nullptr;
 	}
-}
 
-RING_FUNC(ring_json_decode)
-{
-	if (RING_API_PARACOUNT != 1)
+  private:
+	std::vector<char *> aBlocks;
+	std::vector<std::pair<void *, size_t>> aLarge;
+	size_t nUsed = 0; // blocks handed out since the last reset
+	char *pCursor = nullptr;
+	char *pLimit = nullptr;
+
+	void *do_allocate(size_t nBytes, size_t nAlign) override
 	{
-		RING_API_ERROR(RING_API_MISS1PARA);
-		return;
+		if (nBytes + nAlign > JSON_ARENA_LARGE_MIN)
+		{
+			void *pData = ::operator new(nBytes, std::align_val_t(nAlign));
+			aLarge.emplace_back(pData, nAlign);
+			return pData;
+		}
+		for (;;)
+		{
+			uintptr_t nStart = (reinterpret_cast<uintptr_t>(pCursor) + nAlign - 1) & ~static_cast<uintptr_t>(nAlign - 1);
+			if (pCursor && nStart + nBytes <= reinterpret_cast<uintptr_t>(pLimit))
+			{
+				pCursor = reinterpret_cast<char *>(nStart + nBytes);
+				return reinterpret_cast<void *>(nStart);
+			}
+			if (nUsed == aBlocks.size())
+			{
+				aBlocks.push_back(static_cast<char *>(::operator new(JSON_ARENA_BLOCK_SIZE)));
+			}
+			pCursor = aBlocks[nUsed++];
+			pLimit = pCursor + JSON_ARENA_BLOCK_SIZE;
+		}
 	}
 
-	if (!RING_API_ISSTRING(1))
+	void do_deallocate(void *, size_t, size_t) override
 	{
-		RING_API_ERROR(RING_API_BADPARATYPE);
-		return;
 	}
 
-	const char *cJsonString = RING_API_GETSTRING(1);
-	std::string_view jsonView(cJsonString);
+	bool do_is_equal(const std::pmr::memory_resource &oOther) const noexcept override
+	{
+		return this == &oOther;
+	}
+};
 
-	glz::generic jsonRoot;
-	auto ec = glz::read_json(jsonRoot, jsonView);
+// Arena borrowed from a per-thread pool for the temporary trees of a call.
+// Declare it before the trees that use it, so they are destroyed first.
+class json_tree_arena
+{
+  public:
+	json_tree_arena()
+	{
+		auto &aPool = pool();
+		if (!aPool.empty())
+		{
+			pArena = std::move(aPool.back());
+			aPool.pop_back();
+		}
+		else
+		{
+			pArena = std::make_unique<json_arena_resource>();
+		}
+	}
 
-	if (ec)
+	~json_tree_arena()
 	{
-		std::string errorMsg = "JSON error: " + std::string(glz::format_error(ec, jsonView));
-		RING_API_ERROR(errorMsg.c_str());
-		return;
+		pArena->reset();
+		auto &aPool = pool();
+		if (aPool.size() < JSON_BUFFER_POOL_SIZE)
+		{
+			aPool.push_back(std::move(pArena));
+		}
 	}
 
-	List *pTempList = RING_API_NEWLIST;
-	json_value_to_ring_item(RING_API_STATE, jsonRoot, pTempList);
+	json_tree_arena(const json_tree_arena &) = delete;
+	json_tree_arena &operator=(const json_tree_arena &) = delete;
 
-	if (ring_list_getsize(pTempList) == 1 && ring_list_islist(pTempList, 1))
+	std::pmr::memory_resource *resource()
 	{
-		List *pResultList = ring_list_getlist(pTempList, 1);
-		List *pFinalList = RING_API_NEWLIST;
-		ring_list_swaptwolists(pFinalList, pResultList);
-		RING_API_RETLISTBYREF(pFinalList);
+		return pArena.get();
 	}
-	else
+
+  private:
+	std::unique_ptr<json_arena_resource> pArena;
+
+	static std::vector<std::unique_ptr<json_arena_resource>> &pool()
 	{
-		RING_API_RETLISTBYREF(pTempList);
+		static thread_local std::vector<std::unique_ptr<json_arena_resource>> aPool;
+		return aPool;
 	}
+};
+
+// ============================================================================
+// JSON Reader (single-pass tokenizer used to build Ring lists directly)
+// ============================================================================
+
+// Maximum nesting of objects/arrays accepted by json_reader
+static constexpr size_t JSON_MAX_DEPTH = 1024;
+
+enum json_token
+{
+	JSON_TOKEN_ERROR,
+	JSON_TOKEN_EOF,
+	JSON_TOKEN_OBJECT_BEGIN,
+	JSON_TOKEN_OBJECT_END,
+	JSON_TOKEN_ARRAY_BEGIN,
+	JSON_TOKEN_ARRAY_END,
+	JSON_TOKEN_KEY,
+	JSON_TOKEN_STRING,
+	JSON_TOKEN_NUMBER,
+	JSON_TOKEN_TRUE,
+	JSON_TOKEN_FALSE,
+	JSON_TOKEN_NULL
+};
+
+static inline bool json_is_whitespace(char c)
+{
+	return c == ' ' || c == '\n' || c == '\r' || c == '\t';
 }
 
-static int is_ring_list_a_json_object(List *pList)
+static inline bool json_is_digit(char c)
 {
-	if (IS_JSON_EMPTY_OBJECT(pList))
-	{
-		return 1;
-	}
+	return c >= '0' && c <= '9';
+}
 
-	if (ring_list_getsize(pList) == 0)
-	{
-		return 0;
-	}
+static inline int json_hex_value(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	return -1;
+}
 
-	for (int x = 1; x <= ring_list_getsize(pList); x++)
+// Returns the first byte of p[0..nSize) that does not start a well-formed UTF-8
+// sequence (overlong forms and encoded surrogates are rejected), or nullptr
+static const char *json_utf8_invalid(const char *p, size_t nSize)
+{
+	const unsigned char *s = reinterpret_cast<const unsigned char *>(p);
+	const unsigned char *e = s + nSize;
+	while (s < e)
 	{
-		if (!ring_list_islist(pList, x))
+		// ASCII runs are checked eight bytes at a time
+		while (e - s >= 8)
 		{
-			return 0;
+			uint64_t nChunk;
+			memcpy(&nChunk, s, 8);
+			if (nChunk & 0x8080808080808080ULL)
+			{
+				break;
+			}
+			s += 8;
 		}
-		List *pSubList = ring_list_getlist(pList, x);
-
-		if (!(ring_list_getsize(pSubList) == 2 && ring_list_isstring(pSubList, 1)))
+		if (s >= e)
 		{
-			return 0;
+			break;
+		}
+		unsigned char c = *s;
+		if (c < 0x80)
+		{
+			s++;
+			continue;
+		}
+		size_t nLength;
+		unsigned char nLow = 0x80, nHigh = 0xBF;
+		if (c >= 0xC2 && c <= 0xDF)
+		{
+			nLength = 2;
+		}
+		else if (c >= 0xE0 && c <= 0xEF)
+		{
+			nLength = 3;
+			if (c == 0xE0)
+				nLow = 0xA0;
+			else if (c == 0xED)
+				nHigh = 0x9F;
+		}
+		else if (c >= 0xF0 && c <= 0xF4)
+		{
+			nLength = 4;
+			if (c == 0xF0)
+				nLow = 0x90;
+			else if (c == 0xF4)
+				nHigh = 0x8F;
+		}
+		else
+		{
+			return reinterpret_cast<const char *>(s);
+		}
+		if (static_cast<size_t>(e - s) < nLength || s[1] < nLow || s[1] > nHigh)
+		{
+			return reinterpret_cast<const char *>(s);
+		}
+		for (size_t i = 2; i < nLength; i++)
+		{
+			if ((s[i] & 0xC0) != 0x80)
+			{
+				return reinterpret_cast<const char *>(s);
+			}
 		}
+		s += nLength;
 	}
-	return 1;
+	return nullptr;
 }
 
-static glz::generic ring_list_to_json_value(VM *pVM, List *pList, List *pVisited)
+// Pull tokenizer over a JSON text. Validates the grammar as it goes and never
+// allocates: string and number tokens are returned as views into the input.
+// After an error, pCursor is left at (or just before) the offending byte.
+struct json_reader
 {
-	if (ring_list_findpointer(pVisited, pList))
+	enum
 	{
-		return glz::generic{nullptr};
-	}
-	ring_list_addpointer_gc(pVM->pRingState, pVisited, pList);
+		STATE_VALUE,
+		STATE_FIRST_VALUE,
+		STATE_FIRST_KEY,
+		STATE_KEY,
+		STATE_NEXT,
+		STATE_DONE,
+		STATE_ERROR
+	};
 
-	glz::generic result;
+	const char *pStart;
+	const char *pCursor;
+	const char *pEnd;
+	const char *pText = nullptr;
+	size_t nTextSize = 0;
+	bool bEscaped = false;
+	// Also reject malformed UTF-8 and unpaired \u surrogates inside strings
+	bool bCheckUtf8 = false;
+	int nState = STATE_VALUE;
+	size_t nDepth = 0;
+	char aStack[JSON_MAX_DEPTH];
 
-	if (IS_JSON_EMPTY_OBJECT(pList))
+	json_reader(const char *pBegin, const char *pFinish) : pStart(pBegin), pCursor(pBegin), pEnd(pFinish)
 	{
-		result.data = glz::generic::object_t{};
 	}
-	else if (is_ring_list_a_json_object(pList))
+
+	void skip_whitespace()
 	{
-		glz::generic::object_t obj;
-		for (int x = 1; x <= ring_list_getsize(pList); x++)
+		// Minified input has no whitespace between tokens
+		if (pCursor >= pEnd || !json_is_whitespace(*pCursor))
 		{
-			List *pSubList = ring_list_getlist(pList, x);
-			const char *cKey = ring_list_getstring(pSubList, 1);
-			Item *pValueItem = ring_list_getitem(pSubList, 2);
-			obj[cKey] = ring_item_to_json_value(pVM, pValueItem, pVisited);
+			return;
 		}
-		result.data = std::move(obj);
-	}
-	else
-	{
-		glz::generic::array_t arr;
-		arr.reserve(ring_list_getsize(pList));
-		for (int x = 1; x <= ring_list_getsize(pList); x++)
+#if defined(JSON_USE_SSE2)
+		// Indentation comes in runs: test 16 bytes at a time
+		while (pEnd - pCursor >= 16)
+		{
+			__m128i vChars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pCursor));
+			__m128i vSpace = _mm_or_si128(_mm_cmpeq_epi8(vChars, _mm_set1_epi8(' ')),
+										  _mm_cmpeq_epi8(vChars, _mm_set1_epi8('\n')));
+			__m128i vOther = _mm_or_si128(_mm_cmpeq_epi8(vChars, _mm_set1_epi8('\r')),
+										  _mm_cmpeq_epi8(vChars, _mm_set1_epi8('\t')));
+			unsigned int nMask = ~static_cast<unsigned int>(_mm_movemask_epi8(_mm_or_si128(vSpace, vOther))) & 0xFFFF;
+			if (nMask)
+			{
+				pCursor += std::countr_zero(nMask);
+				return;
+			}
+			pCursor += 16;
+		}
+#elif defined(JSON_USE_NEON)
+		while (pEnd - pCursor >= 16)
+		{
+			uint8x16_t vChars = vld1q_u8(reinterpret_cast<const uint8_t *>(pCursor));
+			uint8x16_t vSpace = vorrq_u8(vceqq_u8(vChars, vdupq_n_u8(' ')), vceqq_u8(vChars, vdupq_n_u8('\n')));
+			uint8x16_t vOther = vorrq_u8(vceqq_u8(vChars, vdupq_n_u8('\r')), vceqq_u8(vChars, vdupq_n_u8('\t')));
+			if (vminvq_u8(vorrq_u8(vSpace, vOther)) != 0xFF)
+			{
+				break;
+			}
+			pCursor += 16;
+		}
+#endif
+		while (pCursor < pEnd && json_is_whitespace(*pCursor))
 		{
-			Item *pItem = ring_list_getitem(pList, x);
-			arr.push_back(ring_item_to_json_value(pVM, pItem, pVisited));
+			pCursor++;
 		}
-		result.data = std::move(arr);
 	}
 
-	ring_list_deletelastitem_gc(pVM->pRingState, pVisited);
-	return result;
-}
-
-static glz::generic ring_item_to_json_value(VM *pVM, Item *pItem, List *pVisited)
-{
-	glz::generic result;
-
-	switch (ring_item_gettype(pItem))
+	// Returns the next token; string/key/number contents are in pText/nTextSize
+	json_token next()
 	{
-	case ITEMTYPE_STRING: {
-		String *pString = ring_item_getstring(pItem);
-		if (ring_string_size(pString) == 0)
-		{
-			result.data = nullptr;
-		}
-		else
+		skip_whitespace();
+		switch (nState)
 		{
-			const char *s = ring_string_get(pString);
-			if (strcmp(s, "__JSON_TRUE__") == 0)
+		case STATE_VALUE:
+			return read_value();
+		case STATE_FIRST_VALUE:
+			if (pCursor < pEnd && *pCursor == ']')
 			{
-				result.data = true;
+				pCursor++;
+				return close(JSON_TOKEN_ARRAY_END);
 			}
-			else if (strcmp(s, "__JSON_FALSE__") == 0)
+			return read_value();
+		case STATE_FIRST_KEY:
+			if (pCursor < pEnd && *pCursor == '}')
 			{
-				result.data = false;
+				pCursor++;
+				return close(JSON_TOKEN_OBJECT_END);
 			}
-			else
+			return read_key();
+		case STATE_KEY:
+			return read_key();
+		case STATE_NEXT:
+			if (pCursor >= pEnd)
+			{
+				return fail();
+			}
+			if (*pCursor == ',')
+			{
+				pCursor++;
+				skip_whitespace();
+				return aStack[nDepth - 1] == '{' ? read_key() : read_value();
+			}
+			if (*pCursor == '}' && aStack[nDepth - 1] == '{')
+			{
+				pCursor++;
+				return close(JSON_TOKEN_OBJECT_END);
+			}
+			if (*pCursor == ']' && aStack[nDepth - 1] == '[')
 			{
-				result.data = std::string(s);
+				pCursor++;
+				return close(JSON_TOKEN_ARRAY_END);
 			}
+			return fail();
+		case STATE_DONE:
+			return JSON_TOKEN_EOF;
+		default:
+			return JSON_TOKEN_ERROR;
 		}
-		break;
-	}
-	case ITEMTYPE_NUMBER: {
-		double nNum = ring_item_getnumber(pItem);
-		result.data = nNum;
-		break;
-	}
-	case ITEMTYPE_LIST:
-		return ring_list_to_json_value(pVM, ring_item_getlist(pItem), pVisited);
-	default:
-		result.data = nullptr;
-		break;
 	}
 
-	return result;
-}
-
-RING_FUNC(ring_json_encode)
-{
-	if (RING_API_PARACOUNT < 1 || RING_API_PARACOUNT > 2)
+	// Skips the remainder of the object/array whose BEGIN token was just read
+	bool skip_container()
 	{
-		RING_API_ERROR(RING_API_BADPARACOUNT);
-		return;
+		size_t nTarget = nDepth - 1;
+		while (nDepth > nTarget)
+		{
+			json_token nToken = next();
+			if (nToken == JSON_TOKEN_ERROR || nToken == JSON_TOKEN_EOF)
+			{
+				return false;
+			}
+		}
+		return true;
 	}
 
-	if (!RING_API_ISLIST(1))
+	// Skips the next complete value
+	bool skip_value()
 	{
-		RING_API_ERROR(RING_API_BADPARATYPE);
-		return;
+		json_token nToken = next();
+		if (nToken == JSON_TOKEN_OBJECT_BEGIN || nToken == JSON_TOKEN_ARRAY_BEGIN)
+		{
+			return skip_container();
+		}
+		return nToken != JSON_TOKEN_ERROR && nToken != JSON_TOKEN_EOF && nToken != JSON_TOKEN_KEY &&
+			   nToken != JSON_TOKEN_OBJECT_END && nToken != JSON_TOKEN_ARRAY_END;
 	}
 
-	if (RING_API_ISOBJECT(1))
+	// True once the root value is complete and only whitespace remains
+	bool finish()
 	{
-		RING_API_ERROR(
-			"Cannot encode a Ring object directly to JSON. Convert the object to a list of attributes first.");
-		return;
+		if (nState != STATE_DONE)
+		{
+			return false;
+		}
+		skip_whitespace();
+		return pCursor == pEnd;
 	}
 
-	bool prettyPrint = false;
-	if (RING_API_PARACOUNT == 2)
+	std::string_view text() const
 	{
-		if (RING_API_ISNUMBER(2) && RING_API_GETNUMBER(2) == 1.0)
-		{
-			prettyPrint = true;
-		}
+		return std::string_view(pText, nTextSize);
 	}
 
-	List *pList = RING_API_GETLIST(1);
-	VM *pVM = static_cast<VM *>(pPointer);
+	// Value of the current JSON_TOKEN_NUMBER
+	double number() const;
 
-	List *pVisited = ring_list_new_gc(pVM->pRingState, 0);
+  private:
+	json_token fail()
+	{
+		nState = STATE_ERROR;
+		return JSON_TOKEN_ERROR;
+	}
 
-	glz::generic jsonRoot = ring_list_to_json_value(pVM, pList, pVisited);
-	ring_list_delete_gc(pVM->pRingState, pVisited);
+	json_token after_value(json_token nToken)
+	{
+		nState = nDepth ? STATE_NEXT : STATE_DONE;
+		return nToken;
+	}
 
-	std::string jsonString;
+	json_token close(json_token nToken)
+	{
+		nDepth--;
+		return after_value(nToken);
+	}
 
-	if (prettyPrint)
+	json_token open(char cKind, int nNextState, json_token nToken)
 	{
-		auto ec = glz::write<glz::opts{.prettify = true}>(jsonRoot, jsonString);
-		if (ec)
+		if (nDepth == JSON_MAX_DEPTH)
 		{
-			RING_API_ERROR("Failed to generate JSON string from list.");
-			return;
+			return fail();
 		}
+		aStack[nDepth++] = cKind;
+		pCursor++;
+		nState = nNextState;
+		return nToken;
 	}
-	else
+
+	json_token literal(const char *cWord, size_t nSize, json_token nToken)
 	{
-		auto ec = glz::write_json(jsonRoot, jsonString);
-		if (ec)
+		if (static_cast<size_t>(pEnd - pCursor) < nSize || memcmp(pCursor, cWord, nSize) != 0)
 		{
-			RING_API_ERROR("Failed to generate JSON string from list.");
-			return;
+			return fail();
 		}
+		pCursor += nSize;
+		return after_value(nToken);
 	}
 
-	RING_API_RETSTRING(jsonString.c_str());
-}
-
-RING_FUNC(ring_json_version)
-{
-	RING_API_RETSTRING(GLAZE_VERSION_STRING);
-}
-
-RING_FUNC(ring_json_true)
-{
-	RING_API_RETSTRING("__JSON_TRUE__");
-}
-
-RING_FUNC(ring_json_false)
-{
-	RING_API_RETSTRING("__JSON_FALSE__");
-}
-
-RING_FUNC(ring_json_is_true)
-{
-	if (RING_API_PARACOUNT != 1)
+	json_token read_value()
 	{
-		RING_API_ERROR(RING_API_MISS1PARA);
-		return;
+		if (pCursor >= pEnd)
+		{
+			return fail();
+		}
+		switch (*pCursor)
+		{
+		case '{':
+			return open('{', STATE_FIRST_KEY, JSON_TOKEN_OBJECT_BEGIN);
+		case '[':
+			return open('[', STATE_FIRST_VALUE, JSON_TOKEN_ARRAY_BEGIN);
+		case '"':
+			return scan_string() ? after_value(JSON_TOKEN_STRING) : fail();
+		case 't':
+			return literal("true", 4, JSON_TOKEN_TRUE);
+		case 'f':
+			return literal("false", 5, JSON_TOKEN_FALSE);
+		case 'n':
+			return literal("null", 4, JSON_TOKEN_NULL);
+		default:
+			return scan_number() ? after_value(JSON_TOKEN_NUMBER) : fail();
+		}
 	}
-	if (!RING_API_ISSTRING(1))
+
+	json_token read_key()
 	{
-		RING_API_RETNUMBER(0.0);
-		return;
+		if (pCursor >= pEnd || *pCursor != '"' || !scan_string())
+		{
+			return fail();
+		}
+		skip_whitespace();
+		if (pCursor >= pEnd || *pCursor != ':')
+		{
+			return fail();
+		}
+		pCursor++;
+		nState = STATE_VALUE;
+		return JSON_TOKEN_KEY;
 	}
-	RING_API_RETNUMBER(strcmp(RING_API_GETSTRING(1), "__JSON_TRUE__") == 0 ? 1.0 : 0.0);
-}
 
-RING_FUNC(ring_json_is_false)
-{
-	if (RING_API_PARACOUNT != 1)
+	bool scan_string()
 	{
-		RING_API_ERROR(RING_API_MISS1PARA);
-		return;
-	}
-	if (!RING_API_ISSTRING(1))
+		const char *p = pCursor + 1;
+		pText = p;
+		bEscaped = false;
+		for (;;)
+		{
+			while (p < pEnd && *p != '"' && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20)
+			{
+				p++;
+			}
+			if (p >= pEnd || static_cast<unsigned char>(*p) < 0x20)
+			{
+				pCursor = p;
+				return false;
+			}
+			if (*p == '"')
+			{
+				break;
+			}
+			bEscaped = true;
+			if (++p >= pEnd)
+			{
+				pCursor = p;
+				return false;
+			}
+			switch (*p)
+			{
+			case '"':
+			case '\\':
+			case '/':
+			case 'b':
+			case 'f':
+			case 'n':
+			case 'r':
+			case 't':
+				p++;
+				break;
+			case 'u':
+				if (!scan_unicode_escape(p))
+				{
+					pCursor = p - 1;
+					return false;
+				}
+				break;
+			default:
+				pCursor = p - 1;
+				return false;
+			}
+		}
+		nTextSize = p - pText;
+		if (bCheckUtf8)
+		{
+			if (const char *pBad = json_utf8_invalid(pText, nTextSize))
+			{
+				pCursor = pBad;
+				return false;
+			}
+		}
+		pCursor = p + 1;
+		return true;
+	}
+
+	static int hex4(const char *p)
+	{
+		int nValue = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			int nDigit = json_hex_value(p[i]);
+			if (nDigit < 0)
+			{
+				return -1;
+			}
+			nValue = (nValue << 4) | nDigit;
+		}
+		return nValue;
+	}
+
+	// p is at the 'u' of "\uXXXX"; advances past the escape (and its low
+	// surrogate, when checking UTF-8)
+	bool scan_unicode_escape(const char *&p)
+	{
+		int nUnit = pEnd - p < 5 ? -1 : hex4(p + 1);
+		if (nUnit < 0)
+		{
+			return false;
+		}
+		p += 5;
+		if (!bCheckUtf8 || nUnit < 0xD800 || nUnit > 0xDFFF)
+		{
+			return true;
+		}
+		if (nUnit > 0xDBFF || pEnd - p < 6 || p[0] != '\\' || p[1] != 'u')
+		{
+			return false;
+		}
+		int nLow = hex4(p + 2);
+		if (nLow < 0xDC00 || nLow > 0xDFFF)
+		{
+			return false;
+		}
+		p += 6;
+		return true;
+	}
+
+	bool scan_number()
+	{
+		const char *p = pCursor;
+		pText = p;
+		if (*p == '-')
+		{
+			p++;
+		}
+		if (p >= pEnd || !json_is_digit(*p))
+		{
+			return false;
+		}
+		if (*p++ != '0')
+		{
+			while (p < pEnd && json_is_digit(*p))
+			{
+				p++;
+			}
+		}
+		if (p < pEnd && *p == '.')
+		{
+			if (++p >= pEnd || !json_is_digit(*p))
+			{
+				return false;
+			}
+			while (p < pEnd && json_is_digit(*p))
+			{
+				p++;
+			}
+		}
+		if (p < pEnd && (*p == 'e' || *p == 'E'))
+		{
+			p++;
+			if (p < pEnd && (*p == '+' || *p == '-'))
+			{
+				p++;
+			}
+			if (p >= pEnd || !json_is_digit(*p))
+			{
+				return false;
+			}
+			while (p < pEnd && json_is_digit(*p))
+			{
+				p++;
+			}
+		}
+		nTextSize = p - pText;
+		pCursor = p;
+		return true;
+	}
+};
+
+// Converts the text of a NUMBER token (already validated by json_reader)
+static double json_parse_number(std::string_view cText)
+{
+	double nValue = 0.0;
+#if defined(__cpp_lib_to_chars)
+	auto result = std::from_chars(cText.data(), cText.data() + cText.size(), nValue);
+	if (result.ec == std::errc())
+	{
+		return nValue;
+	}
+#endif
+	// Out of range values (and toolchains without floating-point from_chars)
+	std::string cNumber(cText);
+	return std::strtod(cNumber.c_str(), nullptr);
+}
+
+double json_reader::number() const
+{
+	return json_parse_number(text());
+}
+
+static void json_append_utf8(std::string &cOut, unsigned int nCode)
+{
+	if (nCode < 0x80)
+	{
+		cOut += static_cast<char>(nCode);
+	}
+	else if (nCode < 0x800)
+	{
+		cOut += static_cast<char>(0xC0 | (nCode >> 6));
+		cOut += static_cast<char>(0x80 | (nCode & 0x3F));
+	}
+	else if (nCode < 0x10000)
+	{
+		cOut += static_cast<char>(0xE0 | (nCode >> 12));
+		cOut += static_cast<char>(0x80 | ((nCode >> 6) & 0x3F));
+		cOut += static_cast<char>(0x80 | (nCode & 0x3F));
+	}
+	else
+	{
+		cOut += static_cast<char>(0xF0 | (nCode >> 18));
+		cOut += static_cast<char>(0x80 | ((nCode >> 12) & 0x3F));
+		cOut += static_cast<char>(0x80 | ((nCode >> 6) & 0x3F));
+		cOut += static_cast<char>(0x80 | (nCode & 0x3F));
+	}
+}
+
+static unsigned int json_read_hex4(const char *p)
+{
+	return (json_hex_value(p[0]) << 12) | (json_hex_value(p[1]) << 8) | (json_hex_value(p[2]) << 4) |
+		   json_hex_value(p[3]);
+}
+
+// Decodes the escapes of a string token (already validated by json_reader) into cOut
+static void json_unescape(std::string_view cText, std::string &cOut)
+{
+	cOut.clear();
+	const char *p = cText.data();
+	const char *pEnd = p + cText.size();
+	while (p < pEnd)
+	{
+		const char *pRun = p;
+		while (p < pEnd && *p != '\\')
+		{
+			p++;
+		}
+		cOut.append(pRun, p - pRun);
+		if (p >= pEnd)
+		{
+			break;
+		}
+		char c = p[1];
+		p += 2;
+		switch (c)
+		{
+		case 'b':
+			cOut += '\b';
+			break;
+		case 'f':
+			cOut += '\f';
+			break;
+		case 'n':
+			cOut += '\n';
+			break;
+		case 'r':
+			cOut += '\r';
+			break;
+		case 't':
+			cOut += '\t';
+			break;
+		case 'u': {
+			unsigned int nCode = json_read_hex4(p);
+			p += 4;
+			if (nCode >= 0xD800 && nCode <= 0xDBFF && pEnd - p >= 6 && p[0] == '\\' && p[1] == 'u')
+			{
+				unsigned int nLow = json_read_hex4(p + 2);
+				if (nLow >= 0xDC00 && nLow <= 0xDFFF)
+				{
+					nCode = 0x10000 + ((nCode - 0xD800) << 10) + (nLow - 0xDC00);
+					p += 6;
+				}
+			}
+			if (nCode >= 0xD800 && nCode <= 0xDFFF)
+			{
+				// Unpaired surrogate
+				nCode = 0xFFFD;
+			}
+			json_append_utf8(cOut, nCode);
+			break;
+		}
+		default:
+			cOut += c;
+			break;
+		}
+	}
+}
+
+// Text of the current KEY/STRING token of oReader, unescaped into cScratch
+// when it has escapes
+template <class Reader> static std::string_view json_token_text(const Reader &oReader, std::string &cScratch)
+{
+	if (oReader.bEscaped)
+	{
+		json_unescape(oReader.text(), cScratch);
+		return cScratch;
+	}
+	return std::string_view(oReader.pText, oReader.nTextSize);
+}
+
+template <class Reader>
+static void json_add_ring_string(void *pState, List *pList, const Reader &oReader, std::string &cScratch)
+{
+	std::string_view cText = json_token_text(oReader, cScratch);
+	ring_list_addstring2_gc(pState, pList, cText.data(), cText.size());
+}
+
+// Members an object may have before its keys are hashed instead of scanned
+constexpr int JSON_MEMBER_SCAN_MAX = 8;
+
+// Member pairs of a Ring object list being decoded, so that a repeated key
+// replaces the earlier value (the last one wins, as in json_parse() trees)
+// instead of adding a second pair
+struct json_ring_members
+{
+	List *pObject;
+	int nFirst; // position of the first member in pObject
+	std::unordered_map<std::string_view, List *> mIndex; // filled once the object outgrows a scan
+
+	static std::string_view key(List *pPair)
+	{
+		return std::string_view(ring_list_getstring(pPair, 1), ring_list_getstringsize(pPair, 1));
+	}
+
+	List *find(std::string_view cKey)
+	{
+		int nSize = ring_list_getsize(pObject);
+		if (mIndex.empty())
+		{
+			if (nSize - nFirst < JSON_MEMBER_SCAN_MAX)
+			{
+				for (int x = nFirst; x <= nSize; x++)
+				{
+					List *pPair = ring_list_getlist(pObject, x);
+					if (key(pPair) == cKey)
+					{
+						return pPair;
+					}
+				}
+				return nullptr;
+			}
+			for (int x = nFirst; x <= nSize; x++)
+			{
+				List *pPair = ring_list_getlist(pObject, x);
+				mIndex.emplace(key(pPair), pPair);
+			}
+		}
+		auto it = mIndex.find(cKey);
+		return it == mIndex.end() ? nullptr : it->second;
+	}
+
+	void add(List *pPair)
+	{
+		if (!mIndex.empty())
+		{
+			mIndex.emplace(key(pPair), pPair);
+		}
+	}
+};
+
+// Reads the next complete value from oReader (a json_reader, or a
+// json_tape_reader replaying pre-scanned tokens) and appends it to pList.
+// With bInline, the members/elements of a root object/array are added to pList
+// itself instead of to a new sub-list. Objects with at least nIndexMin members
+// (0: none) get Ring's hash index, so string subscripts skip the linear scan.
+// A repeated object key keeps its first position and takes the last value.
+template <class Reader>
+static bool json_read_ring_item(void *pState, Reader &oReader, List *pList, bool bInline, size_t nIndexMin = 0)
+{
+	// Parent list of each open list, and whether the open list is an object member pair
+	std::vector<std::pair<List *, bool>> aParents;
+	// Members of each open object; entries past nObjects are kept for reuse
+	std::vector<json_ring_members> aObjects;
+	size_t nObjects = 0;
+	std::string cScratch;
+	List *pCurrent = pList;
+	bool bRoot = true;
+
+	do
+	{
+		json_token nToken = oReader.next();
+		switch (nToken)
+		{
+		case JSON_TOKEN_OBJECT_BEGIN:
+		case JSON_TOKEN_ARRAY_BEGIN:
+			aParents.push_back({pCurrent, false});
+			if (!(bRoot && bInline))
+			{
+				pCurrent = ring_list_newlist_gc(pState, pCurrent);
+			}
+			if (nToken == JSON_TOKEN_OBJECT_BEGIN)
+			{
+				if (nObjects == aObjects.size())
+				{
+					aObjects.emplace_back();
+				}
+				json_ring_members &oMembers = aObjects[nObjects++];
+				oMembers.pObject = pCurrent;
+				oMembers.nFirst = ring_list_getsize(pCurrent) + 1;
+				oMembers.mIndex.clear();
+			}
+			bRoot = false;
+			continue;
+		case JSON_TOKEN_KEY: {
+			std::string_view cKey = json_token_text(oReader, cScratch);
+			json_ring_members &oMembers = aObjects[nObjects - 1];
+			aParents.push_back({pCurrent, true});
+			pCurrent = oMembers.find(cKey);
+			if (pCurrent)
+			{
+				// Repeated key: the pair keeps its place and takes the new value
+				ring_list_deleteitem_gc(pState, pCurrent, 2);
+			}
+			else
+			{
+				pCurrent = ring_list_newlist_gc(pState, oMembers.pObject);
+				ring_list_addstring2_gc(pState, pCurrent, cKey.data(), cKey.size());
+				oMembers.add(pCurrent);
+			}
+			continue;
+		}
+		case JSON_TOKEN_OBJECT_END:
+			nObjects--;
+			if (nIndexMin && (size_t)ring_list_getsize(pCurrent) >= nIndexMin)
+			{
+				ring_list_genhashtable2_gc(pState, pCurrent);
+			}
+			[[fallthrough]];
+		case JSON_TOKEN_ARRAY_END:
+			pCurrent = aParents.back().first;
+			aParents.pop_back();
+			break;
+		case JSON_TOKEN_STRING:
+			json_add_ring_string(pState, pCurrent, oReader, cScratch);
+			break;
+		case JSON_TOKEN_NUMBER:
+			ring_list_adddouble_gc(pState, pCurrent, oReader.number());
+			break;
+		case JSON_TOKEN_TRUE:
+			ring_list_addstring2_gc(pState, pCurrent, JSON_TRUE_MARKER, sizeof(JSON_TRUE_MARKER) - 1);
+			break;
+		case JSON_TOKEN_FALSE:
+			ring_list_addstring2_gc(pState, pCurrent, JSON_FALSE_MARKER, sizeof(JSON_FALSE_MARKER) - 1);
+			break;
+		case JSON_TOKEN_NULL:
+			ring_list_addstring2_gc(pState, pCurrent, RING_CSTR_EMPTY, 0);
+			break;
+		default:
+			return false;
+		}
+
+		// A value is complete; leave the member pair it belonged to
+		if (!aParents.empty() && aParents.back().second)
+		{
+			pCurrent = aParents.back().first;
+			aParents.pop_back();
+		}
+		bRoot = false;
+	} while (!aParents.empty());
+
+	return true;
+}
+
+// Decodes a whole JSON document into pList (see json_read_ring_item for bInline
+// and nIndexMin)
+static bool json_decode_to_ring(void *pState, std::string_view jsonView, List *pList, size_t nIndexMin = 0)
+{
+	json_reader oReader(jsonView.data(), jsonView.data() + jsonView.size());
+	return json_read_ring_item(pState, oReader, pList, true, nIndexMin) && oReader.finish();
+}
+
+// Helper: string alternative of a document value (std::string in glz::generic,
+// an allocator-aware string in json_value)
+template <class Value> static auto *json_value_string(const Value &value)
+{
+	if constexpr (requires { typename Value::string_t; })
+	{
+		return value.template get_if<typename Value::string_t>();
+	}
+	else
+	{
+		return value.template get_if<std::string>();
+	}
+}
+
+// Appends a parsed value (a json_value document tree, or a glz::generic from
+// the glaze fallbacks) to pList, indexing objects as json_read_ring_item does
+template <class Value>
+static void json_value_to_ring_item(void *pState, const Value &value, List *pList, size_t nIndexMin = 0)
+{
+	if (auto *obj = value.template get_if<typename Value::object_t>())
+	{
+		List *pObjectList = ring_list_newlist_gc(pState, pList);
+		for (const auto &[key, val] : *obj)
+		{
+			List *pItemList = ring_list_newlist_gc(pState, pObjectList);
+			ring_list_addstring2_gc(pState, pItemList, key.data(), key.size());
+			json_value_to_ring_item(pState, val, pItemList, nIndexMin);
+		}
+		if (nIndexMin && obj->size() >= nIndexMin)
+		{
+			ring_list_genhashtable2_gc(pState, pObjectList);
+		}
+	}
+	else if (auto *arr = value.template get_if<typename Value::array_t>())
+	{
+		List *pArrayList = ring_list_newlist_gc(pState, pList);
+		for (const auto &val : *arr)
+		{
+			json_value_to_ring_item(pState, val, pArrayList, nIndexMin);
+		}
+	}
+	else if (auto *str = json_value_string(value))
+	{
+		ring_list_addstring2_gc(pState, pList, str->data(), str->size());
+	}
+	else if (auto *num = value.template get_if<double>())
+	{
+		ring_list_adddouble_gc(pState, pList, *num);
+	}
+	else if (auto *b = value.template get_if<bool>())
+	{
+		ring_list_addstring_gc(pState, pList, *b ? JSON_TRUE_MARKER : JSON_FALSE_MARKER);
+	}
+	else
+	{
+		ring_list_addstring_gc(pState, pList, RING_CSTR_EMPTY);
+	}
+}
+
+// Parses a JSON document into a new Ring list: a root object/array becomes the
+// list itself, a scalar root becomes its single item. Raises the Ring error and
+// returns NULL on malformed input.
+static List *json_text_to_ring_list(void *pPointer, std::string_view jsonView, size_t nIndexMin = 0)
+{
+	List *pList = RING_API_NEWLIST;
+	if (json_decode_to_ring(RING_API_STATE, jsonView, pList, nIndexMin))
+	{
+		return pList;
+	}
+
+	// Let glaze have the final word on input the single-pass reader rejects, so
+	// error messages (and anything glaze is more lenient about) are unchanged.
+	ring_list_deleteallitems_gc(RING_API_STATE, pList);
+
+	glz::generic jsonRoot;
+	auto ec = glz::read_json(jsonRoot, jsonView);
+	if (ec)
+	{
+		std::string errorMsg = "JSON error: " + std::string(glz::format_error(ec, jsonView));
+		RING_API_ERROR(errorMsg.c_str());
+		return nullptr;
+	}
+
+	json_value_to_ring_item(RING_API_STATE, jsonRoot, pList, nIndexMin);
+
+	if (ring_list_getsize(pList) == 1 && ring_list_islist(pList, 1))
+	{
+		List *pFinalList = RING_API_NEWLIST;
+		ring_list_swaptwolists(pFinalList, ring_list_getlist(pList, 1));
+		return pFinalList;
+	}
+	return pList;
+}
+
+RING_FUNC(ring_json_decode)
+{
+	if (RING_API_PARACOUNT < 1 || RING_API_PARACOUNT > 2)
+	{
+		RING_API_ERROR(RING_API_BADPARACOUNT);
+		return;
+	}
+
+	if (!RING_API_ISSTRING(1) ||
+		(RING_API_PARACOUNT == 2 && (!RING_API_ISNUMBER(2) || RING_API_GETNUMBER(2) < 0)))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	std::string_view jsonView = JSON_STRING_PARAM(1);
+	size_t nIndexMin = RING_API_PARACOUNT == 2 ? json_size_from_number(RING_API_GETNUMBER(2)) : 0;
+
+	List *pList = json_text_to_ring_list(pPointer, jsonView, nIndexMin);
+	if (pList)
+	{
+		RING_API_RETLISTBYREF(pList);
+	}
+}
+
+static int is_ring_list_a_json_object(List *pList)
+{
+	if (IS_JSON_EMPTY_OBJECT(pList))
+	{
+		return 1;
+	}
+
+	if (ring_list_getsize(pList) == 0)
+	{
+		return 0;
+	}
+
+	for (int x = 1; x <= ring_list_getsize(pList); x++)
+	{
+		if (!ring_list_islist(pList, x))
+		{
+			return 0;
+		}
+		List *pSubList = ring_list_getlist(pList, x);
+
+		if (!(ring_list_getsize(pSubList) == 2 && ring_list_isstring(pSubList, 1)))
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+// ============================================================================
+// JSON Writer (serializes Ring lists directly to JSON text)
+// ============================================================================
+
+// Number of spaces per indentation level in pretty-printed output
+static constexpr int JSON_PRETTY_INDENT = 3;
+
+// Largest indentation json_prettify() accepts, in characters per level
+static constexpr int JSON_PRETTY_INDENT_MAX = 16;
+
+// Characters that can be copied into a JSON string literal unescaped
+struct json_escape_table
+{
+	bool aSafe[256];
+
+	constexpr json_escape_table() : aSafe()
+	{
+		for (int c = 0; c < 256; c++)
+		{
+			aSafe[c] = c >= 0x20 && c != '"' && c != '\\';
+		}
+	}
+};
+
+static constexpr json_escape_table JSON_ESCAPE_TABLE{};
+
+static void json_write_string(std::string &cOut, const char *pData, size_t nSize)
+{
+	static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+	const char *p = pData;
+	const char *pEnd = pData + nSize;
+
+	cOut += '"';
+	while (p < pEnd)
+	{
+		const char *pRun = p;
+		while (p < pEnd && JSON_ESCAPE_TABLE.aSafe[static_cast<unsigned char>(*p)])
+		{
+			p++;
+		}
+		cOut.append(pRun, p - pRun);
+		if (p >= pEnd)
+		{
+			break;
+		}
+
+		unsigned char c = static_cast<unsigned char>(*p++);
+		switch (c)
+		{
+		case '"':
+			cOut += "\\\"";
+			break;
+		case '\\':
+			cOut += "\\\\";
+			break;
+		case '\b':
+			cOut += "\\b";
+			break;
+		case '\f':
+			cOut += "\\f";
+			break;
+		case '\n':
+			cOut += "\\n";
+			break;
+		case '\r':
+			cOut += "\\r";
+			break;
+		case '\t':
+			cOut += "\\t";
+			break;
+		default: {
+			char aEscape[6] = {'\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0xF]};
+			cOut.append(aEscape, sizeof(aEscape));
+			break;
+		}
+		}
+	}
+	cOut += '"';
+}
+
+static void json_write_number(std::string &cOut, double nValue)
+{
+	if (!std::isfinite(nValue))
+	{
+		cOut += "null";
+		return;
+	}
+#if defined(__cpp_lib_to_chars)
+	char aBuffer[32];
+	auto result = std::to_chars(aBuffer, aBuffer + sizeof(aBuffer), nValue);
+	cOut.append(aBuffer, result.ptr - aBuffer);
+#else
+	thread_local std::string cNumber;
+	glz::write_json(nValue, cNumber);
+	cOut += cNumber;
+#endif
+}
+
+static void json_write_indent(std::string &cOut, size_t nLevel)
+{
+	cOut += '\n';
+	cOut.append(nLevel * JSON_PRETTY_INDENT, ' ');
+}
+
+// JSON value a Ring string stands for: the boolean sentinels, null for an
+// empty string, a JSON string otherwise
+static json_token json_ring_string_token(const char *cString, size_t nSize)
+{
+	if (nSize == 0)
+	{
+		return JSON_TOKEN_NULL;
+	}
+	if (json_is_marker(cString, nSize, JSON_TRUE_MARKER))
+	{
+		return JSON_TOKEN_TRUE;
+	}
+	if (json_is_marker(cString, nSize, JSON_FALSE_MARKER))
+	{
+		return JSON_TOKEN_FALSE;
+	}
+	return JSON_TOKEN_STRING;
+}
+
+// ============================================================================
+// JSON Shapes (json_shape_compile handles)
+// ============================================================================
+
+static constexpr const char *JSON_SHAPE_TYPE = "JSON_SHAPE";
+
+enum json_shape_kind
+{
+	JSON_SHAPE_ANY,
+	JSON_SHAPE_OBJECT,
+	JSON_SHAPE_ARRAY
+};
+
+struct json_shape_member
+{
+	std::string cName;
+	std::string cKey; // cName as an escaped JSON string, ready to be written
+	size_t nShape;
+};
+
+struct json_shape_node
+{
+	json_shape_kind nKind = JSON_SHAPE_ANY;
+	std::vector<json_shape_member> aMembers; // objects, in template order
+	size_t nElement = 0;					 // arrays: shape of every element
+};
+
+// What the encoder can assume about a family of Ring lists: which lists are
+// objects or arrays, and which keys objects are expected to have. Node 0 is
+// the root.
+struct json_shape
+{
+	std::vector<json_shape_node> aNodes;
+
+	// Member for the key at (0-based) position nPosition of an object; members
+	// are tried in template order first, so well-ordered data takes one compare
+	const json_shape_member *find_member(const json_shape_node &oNode, size_t nPosition, const char *cKey,
+										 size_t nSize) const
+	{
+		auto fnMatches = [&](const json_shape_member &oMember) {
+			return oMember.cName.size() == nSize && memcmp(oMember.cName.data(), cKey, nSize) == 0;
+		};
+		if (nPosition < oNode.aMembers.size() && fnMatches(oNode.aMembers[nPosition]))
+		{
+			return &oNode.aMembers[nPosition];
+		}
+		for (const auto &oMember : oNode.aMembers)
+		{
+			if (fnMatches(oMember))
+			{
+				return &oMember;
+			}
+		}
+		return nullptr;
+	}
+
+	// Compiles the next value of a template: objects list their members, an
+	// array holds the template of its elements (none for any), and any scalar
+	// leaves the value to be detected as usual
+	bool compile(json_reader &oReader, size_t &nShape)
+	{
+		nShape = aNodes.size();
+		aNodes.emplace_back();
+		std::string cScratch;
+		switch (oReader.next())
+		{
+		case JSON_TOKEN_OBJECT_BEGIN:
+			aNodes[nShape].nKind = JSON_SHAPE_OBJECT;
+			for (;;)
+			{
+				json_token nToken = oReader.next();
+				if (nToken == JSON_TOKEN_OBJECT_END)
+				{
+					return true;
+				}
+				if (nToken != JSON_TOKEN_KEY)
+				{
+					return false;
+				}
+				json_shape_member oMember;
+				if (oReader.bEscaped)
+				{
+					json_unescape(oReader.text(), oMember.cName);
+				}
+				else
+				{
+					oMember.cName.assign(oReader.pText, oReader.nTextSize);
+				}
+				json_write_string(oMember.cKey, oMember.cName.data(), oMember.cName.size());
+				if (!compile(oReader, oMember.nShape))
+				{
+					return false;
+				}
+				aNodes[nShape].aMembers.push_back(std::move(oMember));
+			}
+		case JSON_TOKEN_ARRAY_BEGIN: {
+			aNodes[nShape].nKind = JSON_SHAPE_ARRAY;
+			oReader.skip_whitespace();
+			size_t nElement = 0;
+			if (oReader.pCursor < oReader.pEnd && *oReader.pCursor == ']')
+			{
+				nElement = aNodes.size();
+				aNodes.emplace_back();
+			}
+			else if (!compile(oReader, nElement))
+			{
+				return false;
+			}
+			aNodes[nShape].nElement = nElement;
+			return oReader.next() == JSON_TOKEN_ARRAY_END;
+		}
+		case JSON_TOKEN_STRING:
+		case JSON_TOKEN_NUMBER:
+		case JSON_TOKEN_TRUE:
+		case JSON_TOKEN_FALSE:
+		case JSON_TOKEN_NULL:
+			return true;
+		default:
+			return false;
+		}
+	}
+};
+
+static void json_shape_free(void *, void *pPointer)
+{
+	delete static_cast<json_shape *>(pPointer);
+}
+
+constexpr size_t JSON_WRITE_CHUNK_SIZE = 64 * 1024;
+
+// Destination of json_write_file(). Output goes to a fresh temporary file
+// next to the target, which replaces the target only once it is complete, so
+// readers never see a partially written file.
+class json_file_sink
+{
+  public:
+	json_file_sink() = default;
+	json_file_sink(const json_file_sink &) = delete;
+	json_file_sink &operator=(const json_file_sink &) = delete;
+
+	~json_file_sink()
+	{
+		if (nFile >= 0)
+		{
+			close_file();
+			remove(cTempPath.c_str());
+		}
+	}
+
+	bool open(const char *cPath)
+	{
+		cTargetPath = cPath;
+#ifndef _WIN32
+		// Replace the file a symbolic link points to, not the link itself
+		char cResolved[PATH_MAX];
+		if (realpath(cPath, cResolved))
+		{
+			cTargetPath = cResolved;
+		}
+		int nMode = 0666;
+		struct stat oStat;
+		if (stat(cTargetPath.c_str(), &oStat) == 0)
+		{
+			nMode = oStat.st_mode & 07777;
+		}
+#endif
+		static std::atomic<unsigned int> nCounter{0};
+		for (int nAttempt = 0; nAttempt < 100; nAttempt++)
+		{
+#ifdef _WIN32
+			cTempPath = cTargetPath + ".tmp." + std::to_string(_getpid()) + "." + std::to_string(nCounter++);
+			nFile = _open(cTempPath.c_str(), _O_CREAT | _O_EXCL | _O_WRONLY | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+			cTempPath = cTargetPath + ".tmp." + std::to_string(getpid()) + "." + std::to_string(nCounter++);
+			nFile = ::open(cTempPath.c_str(), O_CREAT | O_EXCL | O_WRONLY | O_CLOEXEC, 0666);
+			if (nFile >= 0 && nMode != 0666)
+			{
+				fchmod(nFile, (mode_t)nMode);
+			}
+#endif
+			if (nFile >= 0 || errno != EEXIST)
+			{
+				break;
+			}
+		}
+		return nFile >= 0;
+	}
+
+	bool write(const char *pData, size_t nSize)
+	{
+		while (nSize > 0)
+		{
+#ifdef _WIN32
+			int nWritten = _write(nFile, pData, (unsigned int)std::min<size_t>(nSize, INT_MAX));
+#else
+			ssize_t nWritten = ::write(nFile, pData, nSize);
+			if (nWritten < 0 && errno == EINTR)
+			{
+				continue;
+			}
+#endif
+			if (nWritten <= 0)
+			{
+				return false;
+			}
+			pData += nWritten;
+			nSize -= (size_t)nWritten;
+		}
+		return true;
+	}
+
+	// Moves the finished file into place; with bSync the data and the rename
+	// are flushed to the storage device first, and a failed flush of the
+	// directory is reported even though the file is already in place
+	bool commit(bool bSync)
+	{
+#ifdef _WIN32
+		if (bSync && _commit(nFile) != 0)
+		{
+			return false;
+		}
+		bool bClosed = close_file();
+		if (!bClosed || !MoveFileExA(cTempPath.c_str(), cTargetPath.c_str(),
+									 MOVEFILE_REPLACE_EXISTING | (bSync ? MOVEFILE_WRITE_THROUGH : 0)))
+		{
+			remove(cTempPath.c_str());
+			return false;
+		}
+#else
+		if (bSync && fsync(nFile) != 0)
+		{
+			return false;
+		}
+		bool bClosed = close_file();
+		if (!bClosed || rename(cTempPath.c_str(), cTargetPath.c_str()) != 0)
+		{
+			unlink(cTempPath.c_str());
+			return false;
+		}
+		if (bSync)
+		{
+			size_t nSlash = cTargetPath.rfind('/');
+			std::string cDirectory =
+				nSlash == std::string::npos ? std::string(".") : cTargetPath.substr(0, nSlash ? nSlash : 1);
+			int nDirectory = ::open(cDirectory.c_str(), O_RDONLY | O_CLOEXEC);
+			if (nDirectory < 0)
+			{
+				return false;
+			}
+			bool bSynced = fsync(nDirectory) == 0;
+			::close(nDirectory);
+			if (!bSynced)
+			{
+				return false;
+			}
+		}
+#endif
+		return true;
+	}
+
+  private:
+	int nFile = -1;
+	std::string cTargetPath;
+	std::string cTempPath;
+
+	bool close_file()
+	{
+#ifdef _WIN32
+		int nResult = _close(nFile);
+#else
+		int nResult = ::close(nFile);
+#endif
+		nFile = -1;
+		return nResult == 0;
+	}
+};
+
+// Walks a Ring list once, appending its JSON text to cOut. Lists that are
+// already being written higher up (cycles) are written as null.
+struct ring_json_writer
+{
+	std::string &cOut;
+	bool bPretty;
+	std::vector<List *> aAncestors;
+	json_file_sink *pSink = nullptr; // when set, cOut is handed over in chunks
+	bool bSinkFailed = false;
+
+	ring_json_writer(std::string &cOutput, bool bPrettyPrint) : cOut(cOutput), bPretty(bPrettyPrint)
+	{
+	}
+
+	// Hands cOut to the sink once a chunk is ready. Returns false once the sink
+	// has failed: the output is discarded and the caller stops writing.
+	bool spill()
+	{
+		if (pSink && !bSinkFailed && cOut.size() >= JSON_WRITE_CHUNK_SIZE)
+		{
+			bSinkFailed = !pSink->write(cOut.data(), cOut.size());
+			cOut.clear();
+		}
+		if (bSinkFailed)
+		{
+			cOut.clear();
+			return false;
+		}
+		return true;
+	}
+
+	void write_list(List *pList, size_t nLevel = 0)
+	{
+		if (std::find(aAncestors.begin(), aAncestors.end(), pList) != aAncestors.end())
+		{
+			cOut += "null";
+			return;
+		}
+		aAncestors.push_back(pList);
+
+		int nSize = ring_list_getsize(pList);
+		if (IS_JSON_EMPTY_OBJECT(pList))
+		{
+			cOut += "{}";
+		}
+		else if (is_ring_list_a_json_object(pList))
+		{
+			cOut += '{';
+			for (int x = 1; x <= nSize; x++)
+			{
+				if (x > 1)
+				{
+					cOut += ',';
+					if (!spill())
+					{
+						break;
+					}
+				}
+				if (bPretty)
+				{
+					json_write_indent(cOut, nLevel + 1);
+				}
+				List *pSubList = ring_list_getlist(pList, x);
+				String *pKey = ring_item_getstring(ring_list_getitem(pSubList, 1));
+				json_write_string(cOut, ring_string_get(pKey), ring_string_size(pKey));
+				cOut += bPretty ? ": " : ":";
+				write_item(ring_list_getitem(pSubList, 2), nLevel + 1);
+			}
+			if (bPretty)
+			{
+				json_write_indent(cOut, nLevel);
+			}
+			cOut += '}';
+		}
+		else if (nSize == 0)
+		{
+			cOut += "[]";
+		}
+		else
+		{
+			cOut += '[';
+			for (int x = 1; x <= nSize; x++)
+			{
+				if (x > 1)
+				{
+					cOut += ',';
+					if (!spill())
+					{
+						break;
+					}
+				}
+				if (bPretty)
+				{
+					json_write_indent(cOut, nLevel + 1);
+				}
+				write_item(ring_list_getitem(pList, x), nLevel + 1);
+			}
+			if (bPretty)
+			{
+				json_write_indent(cOut, nLevel);
+			}
+			cOut += ']';
+		}
+
+		aAncestors.pop_back();
+	}
+
+	// Writes pList as node nShape of oShape describes it, instead of probing the
+	// list for its kind. Returns false when the list does not fit the shape.
+	bool write_shaped_list(List *pList, const json_shape &oShape, size_t nShape, size_t nLevel)
+	{
+		if (oShape.aNodes[nShape].nKind == JSON_SHAPE_ANY)
+		{
+			write_list(pList, nLevel);
+			return true;
+		}
+		if (std::find(aAncestors.begin(), aAncestors.end(), pList) != aAncestors.end())
+		{
+			cOut += "null";
+			return true;
+		}
+		aAncestors.push_back(pList);
+		bool bFits = write_shaped_body(pList, oShape, nShape, nLevel);
+		aAncestors.pop_back();
+		return bFits;
+	}
+
+	bool write_shaped_body(List *pList, const json_shape &oShape, size_t nShape, size_t nLevel)
+	{
+		const json_shape_node &oNode = oShape.aNodes[nShape];
+		int nSize = ring_list_getsize(pList);
+		if (oNode.nKind == JSON_SHAPE_ARRAY)
+		{
+			if (nSize == 0)
+			{
+				cOut += "[]";
+				return true;
+			}
+			if (IS_JSON_EMPTY_OBJECT(pList))
+			{
+				return false;
+			}
+			cOut += '[';
+			for (int x = 1; x <= nSize; x++)
+			{
+				if (x > 1)
+				{
+					cOut += ',';
+					if (!spill())
+					{
+						break;
+					}
+				}
+				if (bPretty)
+				{
+					json_write_indent(cOut, nLevel + 1);
+				}
+				if (!write_shaped_item(ring_list_getitem(pList, x), oShape, oNode.nElement, nLevel + 1))
+				{
+					return false;
+				}
+			}
+			if (bPretty)
+			{
+				json_write_indent(cOut, nLevel);
+			}
+			cOut += ']';
+			return true;
+		}
+
+		if (nSize == 0 || IS_JSON_EMPTY_OBJECT(pList))
+		{
+			cOut += "{}";
+			return true;
+		}
+		cOut += '{';
+		for (int x = 1; x <= nSize; x++)
+		{
+			if (!ring_list_islist(pList, x))
+			{
+				return false;
+			}
+			List *pSubList = ring_list_getlist(pList, x);
+			if (ring_list_getsize(pSubList) != 2 || !ring_list_isstring(pSubList, 1))
+			{
+				return false;
+			}
+			if (x > 1)
+			{
+				cOut += ',';
+				if (!spill())
+				{
+					break;
+				}
+			}
+			if (bPretty)
+			{
+				json_write_indent(cOut, nLevel + 1);
+			}
+			String *pKey = ring_item_getstring(ring_list_getitem(pSubList, 1));
+			const json_shape_member *pMember =
+				oShape.find_member(oNode, x - 1, ring_string_get(pKey), ring_string_size(pKey));
+			if (pMember)
+			{
+				cOut += pMember->cKey;
+			}
+			else
+			{
+				json_write_string(cOut, ring_string_get(pKey), ring_string_size(pKey));
+			}
+			cOut += bPretty ? ": " : ":";
+			Item *pValue = ring_list_getitem(pSubList, 2);
+			if (!pMember)
+			{
+				write_item(pValue, nLevel + 1);
+			}
+			else if (!write_shaped_item(pValue, oShape, pMember->nShape, nLevel + 1))
+			{
+				return false;
+			}
+		}
+		if (bPretty)
+		{
+			json_write_indent(cOut, nLevel);
+		}
+		cOut += '}';
+		return true;
+	}
+
+	bool write_shaped_item(Item *pItem, const json_shape &oShape, size_t nShape, size_t nLevel)
+	{
+		if (ring_item_gettype(pItem) == ITEMTYPE_LIST)
+		{
+			return write_shaped_list(ring_item_getlist(pItem), oShape, nShape, nLevel);
+		}
+		write_item(pItem, nLevel);
+		return true;
+	}
+
+	void write_item(Item *pItem, size_t nLevel)
+	{
+		switch (ring_item_gettype(pItem))
+		{
+		case ITEMTYPE_STRING: {
+			String *pString = ring_item_getstring(pItem);
+			switch (json_ring_string_token(ring_string_get(pString), ring_string_size(pString)))
+			{
+			case JSON_TOKEN_NULL:
+				cOut += "null";
+				break;
+			case JSON_TOKEN_TRUE:
+				cOut += "true";
+				break;
+			case JSON_TOKEN_FALSE:
+				cOut += "false";
+				break;
+			default:
+				json_write_string(cOut, ring_string_get(pString), ring_string_size(pString));
+				break;
+			}
+			break;
+		}
+		case ITEMTYPE_NUMBER:
+			json_write_number(cOut, ring_item_getnumber(pItem));
+			break;
+		case ITEMTYPE_LIST:
+			write_list(ring_item_getlist(pItem), nLevel);
+			break;
+		default:
+			cOut += "null";
+			break;
+		}
+	}
+};
+
+RING_FUNC(ring_json_encode)
+{
+	if (RING_API_PARACOUNT < 1 || RING_API_PARACOUNT > 3)
+	{
+		RING_API_ERROR(RING_API_BADPARACOUNT);
+		return;
+	}
+
+	if (!RING_API_ISLIST(1))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	if (RING_API_ISOBJECT(1))
+	{
+		RING_API_ERROR(
+			"Cannot encode a Ring object directly to JSON. Convert the object to a list of attributes first.");
+		return;
+	}
+
+	bool prettyPrint = false;
+	if (RING_API_PARACOUNT >= 2)
+	{
+		if (RING_API_ISNUMBER(2) && RING_API_GETNUMBER(2) == 1.0)
+		{
+			prettyPrint = true;
+		}
+	}
+
+	json_shape *pShape = nullptr;
+	if (RING_API_PARACOUNT == 3)
+	{
+		if (!RING_API_ISCPOINTER(3))
+		{
+			RING_API_ERROR(RING_API_BADPARATYPE);
+			return;
+		}
+		pShape = static_cast<json_shape *>(RING_API_GETCPOINTER(3, JSON_SHAPE_TYPE));
+		if (!pShape)
+		{
+			RING_API_ERROR("Invalid or freed JSON shape handle.");
+			return;
+		}
+	}
+
+	List *pList = RING_API_GETLIST(1);
+
+	json_output_buffer oOutput;
+	std::string &jsonString = oOutput.str();
+	ring_json_writer oWriter(jsonString, prettyPrint);
+	if (!pShape)
+	{
+		oWriter.write_list(pList);
+	}
+	else if (!oWriter.write_shaped_list(pList, *pShape, 0, 0))
+	{
+		RING_API_ERROR("The list does not match the JSON shape.");
+		return;
+	}
+
+	RING_API_RETSTRING2(jsonString.data(), jsonString.size());
+}
+
+RING_FUNC(ring_json_shape_compile)
+{
+	if (RING_API_PARACOUNT != 1)
+	{
+		RING_API_ERROR(RING_API_MISS1PARA);
+		return;
+	}
+
+	if (!RING_API_ISSTRING(1))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	std::string_view specView = JSON_STRING_PARAM(1);
+	json_reader oReader(specView.data(), specView.data() + specView.size());
+	auto *pShape = new json_shape();
+	size_t nRoot = 0;
+	if (!pShape->compile(oReader, nRoot) || !oReader.finish())
+	{
+		delete pShape;
+		RING_API_ERROR("Invalid JSON shape template.");
+		return;
+	}
+
+	RING_API_RETMANAGEDCPOINTER(pShape, JSON_SHAPE_TYPE, json_shape_free);
+}
+
+RING_FUNC(ring_json_version)
+{
+	RING_API_RETSTRING(GLAZE_VERSION_STRING);
+}
+
+RING_FUNC(ring_json_true)
+{
+	RING_API_RETSTRING2(JSON_TRUE_MARKER, sizeof(JSON_TRUE_MARKER) - 1);
+}
+
+RING_FUNC(ring_json_false)
+{
+	RING_API_RETSTRING2(JSON_FALSE_MARKER, sizeof(JSON_FALSE_MARKER) - 1);
+}
+
+RING_FUNC(ring_json_null)
+{
+	RING_API_RETSTRING2(RING_CSTR_EMPTY, 0);
+}
+
+RING_FUNC(ring_json_empty_object)
+{
+	List *pList = RING_API_NEWLIST;
+	ring_list_addstring2_gc(RING_API_STATE, pList, JSON_EMPTY_OBJECT_MARKER, sizeof(JSON_EMPTY_OBJECT_MARKER) - 1);
+	RING_API_RETLISTBYREF(pList);
+}
+
+RING_FUNC(ring_json_is_true)
+{
+	if (RING_API_PARACOUNT != 1)
+	{
+		RING_API_ERROR(RING_API_MISS1PARA);
+		return;
+	}
+	if (!RING_API_ISSTRING(1))
+	{
+		RING_API_RETNUMBER(0.0);
+		return;
+	}
+	bool bTrue = json_is_marker(RING_API_GETSTRING(1), RING_API_GETSTRINGSIZE(1), JSON_TRUE_MARKER);
+	RING_API_RETNUMBER(bTrue ? 1.0 : 0.0);
+}
+
+RING_FUNC(ring_json_is_false)
+{
+	if (RING_API_PARACOUNT != 1)
+	{
+		RING_API_ERROR(RING_API_MISS1PARA);
+		return;
+	}
+	if (!RING_API_ISSTRING(1))
+	{
+		RING_API_RETNUMBER(0.0);
+		return;
+	}
+	bool bFalse = json_is_marker(RING_API_GETSTRING(1), RING_API_GETSTRINGSIZE(1), JSON_FALSE_MARKER);
+	RING_API_RETNUMBER(bFalse ? 1.0 : 0.0);
+}
+
+RING_FUNC(ring_json_tobool)
+{
+	if (RING_API_PARACOUNT != 1)
+	{
+		RING_API_ERROR(RING_API_MISS1PARA);
+		return;
+	}
+	if (RING_API_ISSTRING(1))
+	{
+		switch (json_ring_string_token(RING_API_GETSTRING(1), RING_API_GETSTRINGSIZE(1)))
+		{
+		case JSON_TOKEN_TRUE:
+			RING_API_RETNUMBER(1.0);
+			return;
+		case JSON_TOKEN_FALSE:
+			RING_API_RETNUMBER(0.0);
+			return;
+		default:
+			break;
+		}
+	}
+	RING_API_ERROR("Not a JSON boolean value.");
+}
+
+// Structural and UTF-8 check without building a tree. On failure nErrorOffset
+// is the 0-based byte offset where the input stopped being valid JSON.
+static bool json_validate(std::string_view json, size_t &nErrorOffset)
+{
+	json_reader oReader(json.data(), json.data() + json.size());
+	oReader.bCheckUtf8 = true;
+	if (oReader.skip_value() && oReader.finish())
+	{
+		return true;
+	}
+	nErrorOffset = oReader.pCursor - oReader.pStart;
+	return false;
+}
+
+RING_FUNC(ring_json_valid)
+{
+	if (RING_API_PARACOUNT != 1)
+	{
+		RING_API_ERROR(RING_API_MISS1PARA);
+		return;
+	}
+
+	if (!RING_API_ISSTRING(1))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	size_t nOffset;
+	RING_API_RETNUMBER(json_validate(JSON_STRING_PARAM(1), nOffset) ? 1.0 : 0.0);
+}
+
+RING_FUNC(ring_json_valid_many)
+{
+	if (RING_API_PARACOUNT != 1)
+	{
+		RING_API_ERROR(RING_API_MISS1PARA);
+		return;
+	}
+
+	if (!RING_API_ISLIST(1))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	void *pState = RING_API_STATE;
+	List *pInput = RING_API_GETLIST(1);
+	List *pResults = RING_API_NEWLIST;
+	int nCount = ring_list_getsize(pInput);
+
+	for (int i = 1; i <= nCount; i++)
+	{
+		bool bValid = false;
+		size_t nOffset = 0;
+		if (ring_list_isstring(pInput, i))
+		{
+			std::string_view jsonView(ring_list_getstring(pInput, i), ring_list_getstringsize(pInput, i));
+			// Report the error position 1-based, like Ring string indexes
+			bValid = json_validate(jsonView, nOffset);
+			nOffset = bValid ? 0 : nOffset + 1;
+		}
+
+		List *pItem = ring_list_newlist_gc(pState, pResults);
+		List *pPair = ring_list_newlist_gc(pState, pItem);
+		ring_list_addstring_gc(pState, pPair, "valid");
+		ring_list_adddouble_gc(pState, pPair, bValid ? 1.0 : 0.0);
+		pPair = ring_list_newlist_gc(pState, pItem);
+		ring_list_addstring_gc(pState, pPair, "offset");
+		ring_list_adddouble_gc(pState, pPair, static_cast<double>(nOffset));
+	}
+
+	RING_API_RETLISTBYREF(pResults);
+}
+
+// ============================================================================
+// JSON Formatter (token-level minify / prettify)
+// ============================================================================
+
+struct json_format_options
+{
+	bool bPretty = false;
+	char cIndent = ' ';
+	size_t nIndentWidth = JSON_PRETTY_INDENT; // indent characters per level
+	size_t nMaxLineWidth = 0;				  // arrays of scalars that fit stay on one line; 0 = never
+};
+
+// Width of the array whose contents start at p once written on one line, or
+// SIZE_MAX when it holds containers or is wider than nLimit
+static size_t json_inline_array_width(const char *p, const char *pEnd, size_t nLimit)
+{
+	size_t nWidth = 2; // brackets
+	while (p < pEnd && nWidth <= nLimit)
+	{
+		char c = *p;
+		if (c == '"')
+		{
+			const char *pStart = p++;
+			while (p < pEnd && *p != '"')
+			{
+				p += *p == '\\' ? 2 : 1;
+			}
+			p++;
+			nWidth += p - pStart;
+			continue;
+		}
+		if (c == ']')
+		{
+			return nWidth;
+		}
+		if (c == '[' || c == '{')
+		{
+			return SIZE_MAX;
+		}
+		if (!json_is_whitespace(c))
+		{
+			nWidth += c == ',' ? 2 : 1;
+		}
+		p++;
+	}
+	return SIZE_MAX;
+}
+
+// Rewrites a JSON text without building a tree: strings and numbers are copied
+// verbatim from the input and only the whitespace between tokens changes.
+// Returns false when the text is not valid JSON.
+static bool json_format(std::string_view cInput, const json_format_options &oOptions, std::string &cOut)
+{
+	json_reader oReader(cInput.data(), cInput.data() + cInput.size());
+	cOut.reserve(cInput.size());
+
+	size_t nDepth = 0;
+	size_t nLineStart = 0;
+	bool bFirst = true;	   // no member/element written yet in the open container
+	bool bAfterKey = false; // the next token is a member value
+	bool bInline = false;  // inside an array written on one line
+
+	auto fnNewLine = [&](size_t nLevel) {
+		cOut += '\n';
+		nLineStart = cOut.size();
+		cOut.append(nLevel * oOptions.nIndentWidth, oOptions.cIndent);
+	};
+
+	do
+	{
+		json_token nToken = oReader.next();
+		if (nToken == JSON_TOKEN_ERROR || nToken == JSON_TOKEN_EOF)
+		{
+			return false;
+		}
+
+		if (nToken == JSON_TOKEN_OBJECT_END || nToken == JSON_TOKEN_ARRAY_END)
+		{
+			nDepth--;
+			if (oOptions.bPretty && !bFirst && !bInline)
+			{
+				fnNewLine(nDepth);
+			}
+			cOut += nToken == JSON_TOKEN_OBJECT_END ? '}' : ']';
+			bFirst = false;
+			bInline = false;
+			continue;
+		}
+
+		if (nDepth > 0 && !bAfterKey)
+		{
+			if (!bFirst)
+			{
+				cOut += ',';
+			}
+			if (bInline)
+			{
+				if (!bFirst)
+				{
+					cOut += ' ';
+				}
+			}
+			else if (oOptions.bPretty)
+			{
+				fnNewLine(nDepth);
+			}
+		}
+		bAfterKey = false;
+		bFirst = false;
+
+		switch (nToken)
+		{
+		case JSON_TOKEN_OBJECT_BEGIN:
+			cOut += '{';
+			nDepth++;
+			bFirst = true;
+			break;
+		case JSON_TOKEN_ARRAY_BEGIN:
+			cOut += '[';
+			nDepth++;
+			bFirst = true;
+			if (oOptions.bPretty && oOptions.nMaxLineWidth)
+			{
+				size_t nColumn = cOut.size() - 1 - nLineStart;
+				size_t nLimit = oOptions.nMaxLineWidth > nColumn ? oOptions.nMaxLineWidth - nColumn : 0;
+				bInline = json_inline_array_width(oReader.pCursor, oReader.pEnd, nLimit) <= nLimit;
+			}
+			break;
+		case JSON_TOKEN_KEY:
+			cOut += '"';
+			cOut.append(oReader.pText, oReader.nTextSize);
+			cOut += oOptions.bPretty ? "\": " : "\":";
+			bAfterKey = true;
+			break;
+		case JSON_TOKEN_STRING:
+			cOut += '"';
+			cOut.append(oReader.pText, oReader.nTextSize);
+			cOut += '"';
+			break;
+		case JSON_TOKEN_NUMBER:
+			cOut.append(oReader.pText, oReader.nTextSize);
+			break;
+		case JSON_TOKEN_TRUE:
+			cOut += "true";
+			break;
+		case JSON_TOKEN_FALSE:
+			cOut += "false";
+			break;
+		default:
+			cOut += "null";
+			break;
+		}
+	} while (nDepth > 0);
+
+	return oReader.finish();
+}
+
+RING_FUNC(ring_json_minify)
+{
+	if (RING_API_PARACOUNT != 1)
+	{
+		RING_API_ERROR(RING_API_MISS1PARA);
+		return;
+	}
+
+	if (!RING_API_ISSTRING(1))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	std::string_view input = JSON_STRING_PARAM(1);
+	json_output_buffer oOutput;
+	std::string &result = oOutput.str();
+
+	if (!json_format(input, json_format_options(), result))
+	{
+		// Leave input the formatter rejects to glaze, as before
+		result = glz::minify_json(input);
+		if (result.empty() && !input.empty())
+		{
+			RING_API_ERROR("Failed to minify JSON.");
+			return;
+		}
+	}
+
+	RING_API_RETSTRING2(result.data(), result.size());
+}
+
+RING_FUNC(ring_json_prettify)
+{
+	if (RING_API_PARACOUNT < 1 || RING_API_PARACOUNT > 3)
+	{
+		RING_API_ERROR(RING_API_BADPARACOUNT);
+		return;
+	}
+
+	if (!RING_API_ISSTRING(1))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	json_format_options oOptions;
+	oOptions.bPretty = true;
+
+	// Indentation: a number of spaces, or a tab
+	if (RING_API_PARACOUNT >= 2)
+	{
+		if (RING_API_ISNUMBER(2) && RING_API_GETNUMBER(2) >= 0 && RING_API_GETNUMBER(2) <= JSON_PRETTY_INDENT_MAX)
+		{
+			oOptions.nIndentWidth = (size_t)RING_API_GETNUMBER(2);
+		}
+		else if (RING_API_ISSTRING(2) && (JSON_STRING_PARAM(2) == "\t" || JSON_STRING_PARAM(2) == "tab"))
+		{
+			oOptions.cIndent = '\t';
+			oOptions.nIndentWidth = 1;
+		}
+		else
+		{
+			RING_API_ERROR(RING_API_BADPARATYPE);
+			return;
+		}
+	}
+
+	if (RING_API_PARACOUNT == 3)
+	{
+		if (!RING_API_ISNUMBER(3) || RING_API_GETNUMBER(3) < 0)
+		{
+			RING_API_ERROR(RING_API_BADPARATYPE);
+			return;
+		}
+		oOptions.nMaxLineWidth = json_size_from_number(RING_API_GETNUMBER(3));
+	}
+
+	std::string_view input = JSON_STRING_PARAM(1);
+	json_output_buffer oOutput;
+	std::string &result = oOutput.str();
+
+	if (!json_format(input, oOptions, result))
+	{
+		result = glz::prettify_json(input);
+		if (result.empty() && !input.empty())
+		{
+			RING_API_ERROR("Failed to prettify JSON.");
+			return;
+		}
+	}
+
+	RING_API_RETSTRING2(result.data(), result.size());
+}
+
+// ============================================================================
+// Document Trees
+// ============================================================================
+
+// Objects at or above this many members get a hash index for key lookups;
+// smaller ones are scanned, which is faster at that size
+static constexpr size_t JSON_OBJECT_INDEX_MIN = 16;
+
+struct json_value;
+
+// JSON object stored as one contiguous vector of members in document order
+// (glz::generic uses a node-per-member sorted map). Lookups on large objects
+// go through an open-addressing index of member positions.
+class json_object
+{
+  public:
+	using member = std::pair<std::pmr::string, json_value>;
+	using iterator = std::pmr::vector<member>::iterator;
+	using const_iterator = std::pmr::vector<member>::const_iterator;
+
+	explicit json_object(std::pmr::memory_resource *pResource) : aMembers(pResource), aIndex(pResource)
+	{
+	}
+
+	iterator begin();
+	iterator end();
+	const_iterator begin() const;
+	const_iterator end() const;
+	size_t size() const;
+	bool empty() const;
+
+	iterator find(std::string_view cKey);
+	const_iterator find(std::string_view cKey) const;
+
+	// Member value for cKey, appended as null when missing
+	json_value &operator[](std::string_view cKey);
+
+	// Reorders the members by key (byte order)
+	void sort_keys();
+
+  private:
+	std::pmr::vector<member> aMembers;
+	std::pmr::vector<uint32_t> aIndex; // member position + 1 per slot, 0 when empty
+
+	size_t lookup(std::string_view cKey) const;
+	void index_member(size_t nPosition);
+	void rebuild_index();
+};
+
+// Parsed JSON value with the same access pattern as glz::generic. Strings and
+// containers allocate from the value's memory resource: the default heap for
+// json_parse() handles, a json_tree_arena for the temporaries of one call.
+// Values are moved, never copied, and only within one tree.
+struct json_value
+{
+	using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+	using string_t = std::pmr::string;
+	using object_t = json_object;
+	using array_t = std::pmr::vector<json_value>;
+
+	std::variant<std::nullptr_t, bool, double, string_t, array_t, object_t> data;
+	std::pmr::memory_resource *pResource;
+
+	json_value(allocator_type oAllocator = {}) : pResource(oAllocator.resource())
+	{
+	}
+
+	json_value(json_value &&oOther, allocator_type oAllocator)
+		: data(std::move(oOther.data)), pResource(oAllocator.resource())
+	{
+	}
+
+	json_value(json_value &&) = default;
+	json_value &operator=(json_value &&) = default;
+	json_value(const json_value &) = delete;
+	json_value &operator=(const json_value &) = delete;
+
+	object_t &make_object()
+	{
+		return data.emplace<object_t>(pResource);
+	}
+
+	array_t &make_array()
+	{
+		return data.emplace<array_t>(pResource);
+	}
+
+	void set_string(std::string_view cText)
+	{
+		data.emplace<string_t>(cText, pResource);
+	}
+
+	template <class T> T *get_if()
+	{
+		return std::get_if<T>(&data);
+	}
+
+	template <class T> const T *get_if() const
+	{
+		return std::get_if<T>(&data);
+	}
+};
+
+inline json_object::iterator json_object::begin()
+{
+	return aMembers.begin();
+}
+
+inline json_object::iterator json_object::end()
+{
+	return aMembers.end();
+}
+
+inline json_object::const_iterator json_object::begin() const
+{
+	return aMembers.begin();
+}
+
+inline json_object::const_iterator json_object::end() const
+{
+	return aMembers.end();
+}
+
+inline size_t json_object::size() const
+{
+	return aMembers.size();
+}
+
+inline bool json_object::empty() const
+{
+	return aMembers.empty();
+}
+
+inline size_t json_object::lookup(std::string_view cKey) const
+{
+	if (aIndex.empty())
+	{
+		for (size_t i = 0; i < aMembers.size(); i++)
+		{
+			if (aMembers[i].first == cKey)
+			{
+				return i;
+			}
+		}
+		return SIZE_MAX;
+	}
+	size_t nMask = aIndex.size() - 1;
+	for (size_t nSlot = std::hash<std::string_view>{}(cKey) & nMask;; nSlot = (nSlot + 1) & nMask)
+	{
+		uint32_t nEntry = aIndex[nSlot];
+		if (nEntry == 0)
+		{
+			return SIZE_MAX;
+		}
+		if (aMembers[nEntry - 1].first == cKey)
+		{
+			return nEntry - 1;
+		}
+	}
+}
+
+inline json_object::iterator json_object::find(std::string_view cKey)
+{
+	size_t nPosition = lookup(cKey);
+	return nPosition == SIZE_MAX ? aMembers.end() : aMembers.begin() + nPosition;
+}
+
+inline json_object::const_iterator json_object::find(std::string_view cKey) const
+{
+	size_t nPosition = lookup(cKey);
+	return nPosition == SIZE_MAX ? aMembers.end() : aMembers.begin() + nPosition;
+}
+
+inline json_value &json_object::operator[](std::string_view cKey)
+{
+	size_t nPosition = lookup(cKey);
+	if (nPosition != SIZE_MAX)
+	{
+		return aMembers[nPosition].second;
+	}
+	aMembers.emplace_back(std::piecewise_construct, std::forward_as_tuple(cKey), std::forward_as_tuple());
+	if (aMembers.size() >= JSON_OBJECT_INDEX_MIN)
+	{
+		// Keep the index at most half full
+		if (aMembers.size() * 2 > aIndex.size())
+		{
+			rebuild_index();
+		}
+		else
+		{
+			index_member(aMembers.size() - 1);
+		}
+	}
+	return aMembers.back().second;
+}
+
+inline void json_object::sort_keys()
+{
+	std::sort(aMembers.begin(), aMembers.end(),
+			  [](const member &oLeft, const member &oRight) { return oLeft.first < oRight.first; });
+	if (!aIndex.empty())
+	{
+		rebuild_index();
+	}
+}
+
+inline void json_object::index_member(size_t nPosition)
+{
+	size_t nMask = aIndex.size() - 1;
+	size_t nSlot = std::hash<std::string_view>{}(aMembers[nPosition].first) & nMask;
+	while (aIndex[nSlot] != 0)
+	{
+		nSlot = (nSlot + 1) & nMask;
+	}
+	aIndex[nSlot] = static_cast<uint32_t>(nPosition + 1);
+}
+
+inline void json_object::rebuild_index()
+{
+	aIndex.assign(std::bit_ceil(aMembers.size() * 4), 0);
+	for (size_t i = 0; i < aMembers.size(); i++)
+	{
+		index_member(i);
+	}
+}
+
+// Builds a document tree from JSON text in one pass over json_reader tokens.
+// A repeated key keeps its first position and takes the last value.
+static bool json_tree_parse(std::string_view json, json_value &oRoot)
+{
+	json_reader oReader(json.data(), json.data() + json.size());
+	std::vector<json_value *> aOpen;
+	std::string cScratch;
+	json_value *pSlot = &oRoot;
+	auto fnText = [&]() -> std::string_view {
+		if (!oReader.bEscaped)
+		{
+			return oReader.text();
+		}
+		json_unescape(oReader.text(), cScratch);
+		return cScratch;
+	};
+
+	do
+	{
+		json_token nToken = oReader.next();
+		if (nToken != JSON_TOKEN_KEY && nToken != JSON_TOKEN_OBJECT_END && nToken != JSON_TOKEN_ARRAY_END &&
+			!aOpen.empty())
+		{
+			if (auto *pArray = aOpen.back()->get_if<json_value::array_t>())
+			{
+				pSlot = &pArray->emplace_back();
+			}
+		}
+		switch (nToken)
+		{
+		case JSON_TOKEN_OBJECT_BEGIN:
+			pSlot->make_object();
+			aOpen.push_back(pSlot);
+			break;
+		case JSON_TOKEN_ARRAY_BEGIN:
+			pSlot->make_array();
+			aOpen.push_back(pSlot);
+			break;
+		case JSON_TOKEN_OBJECT_END:
+		case JSON_TOKEN_ARRAY_END:
+			aOpen.pop_back();
+			break;
+		case JSON_TOKEN_KEY:
+			pSlot = &(*aOpen.back()->get_if<json_value::object_t>())[fnText()];
+			pSlot->data = nullptr;
+			break;
+		case JSON_TOKEN_STRING:
+			pSlot->set_string(fnText());
+			break;
+		case JSON_TOKEN_NUMBER:
+			pSlot->data = oReader.number();
+			break;
+		case JSON_TOKEN_TRUE:
+		case JSON_TOKEN_FALSE:
+			pSlot->data = nToken == JSON_TOKEN_TRUE;
+			break;
+		case JSON_TOKEN_NULL:
+			pSlot->data = nullptr;
+			break;
+		default:
+			return false;
+		}
+	} while (!aOpen.empty());
+	return oReader.finish();
+}
+
+// Copies a glaze tree (input only glaze accepted) into a document tree
+static void json_tree_from_generic(const glz::generic &value, json_value &oOut)
+{
+	if (auto *obj = value.get_if<glz::generic::object_t>())
+	{
+		auto &oObject = oOut.make_object();
+		for (const auto &[key, val] : *obj)
+		{
+			json_tree_from_generic(val, oObject[key]);
+		}
+	}
+	else if (auto *arr = value.get_if<glz::generic::array_t>())
+	{
+		auto &aArray = oOut.make_array();
+		aArray.resize(arr->size());
+		for (size_t i = 0; i < arr->size(); i++)
+		{
+			json_tree_from_generic((*arr)[i], aArray[i]);
+		}
+	}
+	else if (auto *str = value.get_if<std::string>())
+	{
+		oOut.set_string(*str);
+	}
+	else if (auto *num = value.get_if<double>())
+	{
+		oOut.data = *num;
+	}
+	else if (auto *b = value.get_if<bool>())
+	{
+		oOut.data = *b;
+	}
+	else
+	{
+		oOut.data = nullptr;
+	}
+}
+
+// Parses jsonView into oRoot. Input the single-pass reader rejects goes through
+// glaze, which supplies the error message (cError) or accepts it after all.
+static bool json_tree_load(std::string_view jsonView, json_value &oRoot, std::string &cError)
+{
+	if (json_tree_parse(jsonView, oRoot))
+	{
+		return true;
+	}
+	glz::generic jsonRoot;
+	auto ec = glz::read_json(jsonRoot, jsonView);
+	if (ec)
+	{
+		cError = glz::format_error(ec, jsonView);
+		return false;
+	}
+	json_tree_from_generic(jsonRoot, oRoot);
+	return true;
+}
+
+// Writes a document tree as compact JSON
+static void json_tree_write(std::string &cOut, const json_value &value)
+{
+	if (auto *obj = value.get_if<json_value::object_t>())
+	{
+		cOut += '{';
+		bool bFirst = true;
+		for (const auto &[key, val] : *obj)
+		{
+			if (!bFirst)
+			{
+				cOut += ',';
+			}
+			bFirst = false;
+			json_write_string(cOut, key.data(), key.size());
+			cOut += ':';
+			json_tree_write(cOut, val);
+		}
+		cOut += '}';
+	}
+	else if (auto *arr = value.get_if<json_value::array_t>())
+	{
+		cOut += '[';
+		for (size_t i = 0; i < arr->size(); i++)
+		{
+			if (i > 0)
+			{
+				cOut += ',';
+			}
+			json_tree_write(cOut, (*arr)[i]);
+		}
+		cOut += ']';
+	}
+	else if (auto *str = value.get_if<json_value::string_t>())
+	{
+		json_write_string(cOut, str->data(), str->size());
+	}
+	else if (auto *num = value.get_if<double>())
+	{
+		json_write_number(cOut, *num);
+	}
+	else if (auto *b = value.get_if<bool>())
+	{
+		cOut += *b ? "true" : "false";
+	}
+	else
+	{
+		cOut += "null";
+	}
+}
+
+// ============================================================================
+// Parsed Documents (json_parse handles)
+// ============================================================================
+
+static constexpr const char *JSON_DOCUMENT_TYPE = "JSON_DOCUMENT";
+
+static void json_document_free(void *, void *pPointer)
+{
+	delete static_cast<json_value *>(pPointer);
+}
+
+// Returns the document behind a json_parse() handle, or NULL (after raising
+// an error) when the handle has already been freed.
+static json_value *json_document_param(void *pPointer, int nParam)
+{
+	auto *pDocument = static_cast<json_value *>(RING_API_GETCPOINTER(nParam, JSON_DOCUMENT_TYPE));
+	if (!pDocument)
+	{
+		RING_API_ERROR("Invalid or freed JSON document handle.");
+	}
+	return pDocument;
+}
+
+RING_FUNC(ring_json_parse)
+{
+	if (RING_API_PARACOUNT != 1)
+	{
+		RING_API_ERROR(RING_API_MISS1PARA);
+		return;
+	}
+
+	if (!RING_API_ISSTRING(1))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	std::string_view jsonView = JSON_STRING_PARAM(1);
+
+	auto *pDocument = new json_value();
+	std::string cError;
+	if (!json_tree_load(jsonView, *pDocument, cError))
+	{
+		delete pDocument;
+		std::string errorMsg = "JSON error: " + cError;
+		RING_API_ERROR(errorMsg.c_str());
+		return;
+	}
+
+	RING_API_RETMANAGEDCPOINTER(pDocument, JSON_DOCUMENT_TYPE, json_document_free);
+}
+
+RING_FUNC(ring_json_free)
+{
+	if (RING_API_PARACOUNT != 1)
+	{
+		RING_API_ERROR(RING_API_MISS1PARA);
+		return;
+	}
+
+	if (!RING_API_ISCPOINTER(1))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	auto *pDocument = static_cast<json_value *>(RING_API_GETCPOINTER(1, JSON_DOCUMENT_TYPE));
+	if (pDocument)
+	{
+		delete pDocument;
+		RING_API_SETNULLPOINTER(1);
+	}
+}
+
+// ============================================================================
+// JSON Pointer (RFC 6901)
+// ============================================================================
+
+enum json_seek_result
+{
+	JSON_SEEK_FOUND,
+	JSON_SEEK_NOT_FOUND,
+	JSON_SEEK_OUT_OF_RANGE,
+	JSON_SEEK_INVALID
+};
+
+// Splits a JSON pointer into unescaped reference tokens ("~1" -> "/", "~0" -> "~").
+// A missing leading '/' is tolerated. Returns false on a malformed escape.
+static bool json_pointer_parse(std::string_view cPointer, std::vector<std::string> &aTokens)
+{
+	aTokens.clear();
+	if (cPointer.empty())
+	{
+		return true;
+	}
+	if (cPointer[0] == '/')
+	{
+		cPointer.remove_prefix(1);
+	}
+
+	std::string cToken;
+	for (size_t i = 0; i <= cPointer.size(); i++)
+	{
+		if (i == cPointer.size() || cPointer[i] == '/')
+		{
+			aTokens.push_back(std::move(cToken));
+			cToken.clear();
+		}
+		else if (cPointer[i] == '~')
+		{
+			if (i + 1 == cPointer.size() || (cPointer[i + 1] != '0' && cPointer[i + 1] != '1'))
+			{
+				return false;
+			}
+			cToken += cPointer[++i] == '0' ? '~' : '/';
+		}
+		else
+		{
+			cToken += cPointer[i];
+		}
+	}
+	return true;
+}
+
+// Splits a json_query() path: an optional leading '/', then keys separated by
+// '/' and taken literally (no ~0/~1 escapes). A trailing '/' is ignored, so
+// "/" and "" select the root and "a/" selects "a".
+static std::vector<std::string> json_query_tokens(std::string_view cQuery)
+{
+	std::vector<std::string> aTokens;
+	if (!cQuery.empty() && cQuery[0] == '/')
+	{
+		cQuery.remove_prefix(1);
+	}
+	size_t nSlash;
+	while ((nSlash = cQuery.find('/')) != std::string_view::npos)
+	{
+		aTokens.emplace_back(cQuery.substr(0, nSlash));
+		cQuery.remove_prefix(nSlash + 1);
+	}
+	if (!cQuery.empty())
+	{
+		aTokens.emplace_back(cQuery);
+	}
+	return aTokens;
+}
+
+// Parses an array reference token: decimal digits without leading zeros
+static bool json_pointer_index(const std::string &cToken, size_t &nIndex)
+{
+	if (cToken.empty() || (cToken.size() > 1 && cToken[0] == '0'))
+	{
+		return false;
+	}
+	auto result = std::from_chars(cToken.data(), cToken.data() + cToken.size(), nIndex);
+	return result.ec == std::errc() && result.ptr == cToken.data() + cToken.size();
+}
+
+// Compares the current KEY/STRING token of oReader with cName
+static bool json_reader_text_equals(const json_reader &oReader, std::string_view cName, std::string &cScratch)
+{
+	if (!oReader.bEscaped)
+	{
+		return oReader.text() == cName;
+	}
+	json_unescape(oReader.text(), cScratch);
+	return cScratch == cName;
+}
+
+// Advances oReader to the value addressed by aTokens, skipping every unrelated
+// member and element without materializing it. On JSON_SEEK_FOUND the next
+// token read from oReader is the first token of the target value.
+static json_seek_result json_reader_seek(json_reader &oReader, const std::vector<std::string> &aTokens)
+{
+	std::string cScratch;
+	for (const auto &cToken : aTokens)
+	{
+		json_token nToken = oReader.next();
+		if (nToken == JSON_TOKEN_OBJECT_BEGIN)
+		{
+			for (;;)
+			{
+				nToken = oReader.next();
+				if (nToken == JSON_TOKEN_OBJECT_END)
+				{
+					return JSON_SEEK_NOT_FOUND;
+				}
+				if (nToken != JSON_TOKEN_KEY)
+				{
+					return JSON_SEEK_INVALID;
+				}
+				if (json_reader_text_equals(oReader, cToken, cScratch))
+				{
+					break;
+				}
+				if (!oReader.skip_value())
+				{
+					return JSON_SEEK_INVALID;
+				}
+			}
+		}
+		else if (nToken == JSON_TOKEN_ARRAY_BEGIN)
+		{
+			size_t nIndex = 0;
+			if (!json_pointer_index(cToken, nIndex))
+			{
+				return JSON_SEEK_NOT_FOUND;
+			}
+			for (size_t i = 0;; i++)
+			{
+				oReader.skip_whitespace();
+				if (oReader.pCursor < oReader.pEnd && *oReader.pCursor == ']')
+				{
+					return JSON_SEEK_OUT_OF_RANGE;
+				}
+				if (i == nIndex)
+				{
+					break;
+				}
+				if (!oReader.skip_value())
+				{
+					return JSON_SEEK_INVALID;
+				}
+			}
+		}
+		else if (nToken == JSON_TOKEN_ERROR || nToken == JSON_TOKEN_EOF)
+		{
+			return JSON_SEEK_INVALID;
+		}
+		else
+		{
+			return JSON_SEEK_NOT_FOUND;
+		}
+	}
+	return JSON_SEEK_FOUND;
+}
+
+// Same lookup over an already parsed document
+static json_seek_result json_tree_seek(const json_value &root, const std::vector<std::string> &aTokens,
+										  const json_value *&pValue)
+{
+	const json_value *current = &root;
+	for (const auto &cToken : aTokens)
+	{
+		if (auto *obj = current->get_if<json_value::object_t>())
+		{
+			auto it = obj->find(cToken);
+			if (it == obj->end())
+			{
+				return JSON_SEEK_NOT_FOUND;
+			}
+			current = &(it->second);
+		}
+		else if (auto *arr = current->get_if<json_value::array_t>())
+		{
+			size_t nIndex = 0;
+			if (!json_pointer_index(cToken, nIndex))
+			{
+				return JSON_SEEK_NOT_FOUND;
+			}
+			if (nIndex >= arr->size())
+			{
+				return JSON_SEEK_OUT_OF_RANGE;
+			}
+			current = &((*arr)[nIndex]);
+		}
+		else
+		{
+			return JSON_SEEK_NOT_FOUND;
+		}
+	}
+	pValue = current;
+	return JSON_SEEK_FOUND;
+}
+
+// Re-emits the next value of oReader as compact JSON text (strings and numbers
+// are copied exactly as written)
+static bool json_reader_copy_value(json_reader &oReader, std::string &cOut)
+{
+	size_t nDepth = oReader.nDepth;
+	bool bAfterValue = false;
+	do
+	{
+		json_token nToken = oReader.next();
+		if (bAfterValue && nToken != JSON_TOKEN_OBJECT_END && nToken != JSON_TOKEN_ARRAY_END)
+		{
+			cOut += ',';
+		}
+		bAfterValue = true;
+		switch (nToken)
+		{
+		case JSON_TOKEN_OBJECT_BEGIN:
+			cOut += '{';
+			bAfterValue = false;
+			break;
+		case JSON_TOKEN_ARRAY_BEGIN:
+			cOut += '[';
+			bAfterValue = false;
+			break;
+		case JSON_TOKEN_OBJECT_END:
+			cOut += '}';
+			break;
+		case JSON_TOKEN_ARRAY_END:
+			cOut += ']';
+			break;
+		case JSON_TOKEN_KEY:
+			cOut += '"';
+			cOut += oReader.text();
+			cOut += "\":";
+			bAfterValue = false;
+			break;
+		case JSON_TOKEN_STRING:
+			cOut += '"';
+			cOut += oReader.text();
+			cOut += '"';
+			break;
+		case JSON_TOKEN_NUMBER:
+			cOut += oReader.text();
+			break;
+		case JSON_TOKEN_TRUE:
+			cOut += "true";
+			break;
+		case JSON_TOKEN_FALSE:
+			cOut += "false";
+			break;
+		case JSON_TOKEN_NULL:
+			cOut += "null";
+			break;
+		default:
+			return false;
+		}
+	} while (oReader.nDepth > nDepth);
+	return true;
+}
+
+// Returns the single item of pList (as built by json_value_to_ring_item or
+// json_read_ring_item) to Ring
+static void json_return_single_item(void *pPointer, List *pList)
+{
+	if (ring_list_islist(pList, 1))
+	{
+		List *pFinalList = RING_API_NEWLIST;
+		ring_list_swaptwolists(pFinalList, ring_list_getlist(pList, 1));
+		RING_API_RETLISTBYREF(pFinalList);
+	}
+	else if (ring_list_isstring(pList, 1))
+	{
+		RING_API_RETSTRING2(ring_list_getstring(pList, 1), ring_list_getstringsize(pList, 1));
+	}
+	else
+	{
+		RING_API_RETNUMBER(ring_list_getdouble(pList, 1));
+	}
+}
+
+RING_FUNC(ring_json_pointer)
+{
+	if (RING_API_PARACOUNT != 2)
+	{
+		RING_API_ERROR(RING_API_MISS2PARA);
+		return;
+	}
+
+	if ((!RING_API_ISSTRING(1) && !RING_API_ISCPOINTER(1)) || !RING_API_ISSTRING(2))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	std::vector<std::string> tokens;
+	if (!json_pointer_parse(JSON_STRING_PARAM(2), tokens))
+	{
+		RING_API_ERROR("Invalid JSON pointer.");
+		return;
+	}
+
+	List *pTempList = RING_API_NEWLIST;
+	json_seek_result nResult;
+
+	if (RING_API_ISCPOINTER(1))
+	{
+		json_value *pDocument = json_document_param(pPointer, 1);
+		if (!pDocument)
+		{
+			return;
+		}
+		const json_value *pValue = nullptr;
+		nResult = json_tree_seek(*pDocument, tokens, pValue);
+		if (nResult == JSON_SEEK_FOUND)
+		{
+			json_value_to_ring_item(RING_API_STATE, *pValue, pTempList);
+		}
+	}
+	else
+	{
+		// Lazy lookup: only the target value is materialized, and the text
+		// after it is never looked at
+		std::string_view jsonView = JSON_STRING_PARAM(1);
+		json_reader oReader(jsonView.data(), jsonView.data() + jsonView.size());
+		nResult = json_reader_seek(oReader, tokens);
+		if (nResult == JSON_SEEK_FOUND && !json_read_ring_item(RING_API_STATE, oReader, pTempList, false))
+		{
+			nResult = JSON_SEEK_INVALID;
+		}
+	}
+
+	switch (nResult)
+	{
+	case JSON_SEEK_FOUND:
+		json_return_single_item(pPointer, pTempList);
+		break;
+	case JSON_SEEK_OUT_OF_RANGE:
+		RING_API_ERROR("JSON pointer index out of range.");
+		break;
+	case JSON_SEEK_INVALID:
+		RING_API_ERROR("Invalid JSON input.");
+		break;
+	default:
+		RING_API_ERROR("JSON pointer path not found.");
+		break;
+	}
+}
+
+// Paths of a json_pointer_many() call merged into a trie, so that one walk
+// over the document serves all of them
+struct json_pointer_trie
+{
+	struct node
+	{
+		std::string cToken;
+		size_t nIndex = SIZE_MAX; // cToken as an array index, SIZE_MAX if it is not one
+		std::vector<size_t> aChildren;
+		bool bTerminal = false;
+		bool bCaptured = false;
+		int nHolderIndex = 0; // position of the captured value in pHolder
+	};
+
+	std::vector<node> aNodes;
+	size_t nPending = 0; // terminal nodes not captured yet
+	void *pState = nullptr;
+	List *pHolder = nullptr;
+
+	json_pointer_trie() : aNodes(1)
+	{
+	}
+
+	size_t add(const std::vector<std::string> &aTokens)
+	{
+		size_t nNode = 0;
+		for (const auto &cToken : aTokens)
+		{
+			size_t nChild = 0;
+			for (size_t nCandidate : aNodes[nNode].aChildren)
+			{
+				if (aNodes[nCandidate].cToken == cToken)
+				{
+					nChild = nCandidate;
+					break;
+				}
+			}
+			if (!nChild)
+			{
+				nChild = aNodes.size();
+				aNodes.emplace_back();
+				aNodes[nChild].cToken = cToken;
+				size_t nIndex;
+				if (json_pointer_index(cToken, nIndex))
+				{
+					aNodes[nChild].nIndex = nIndex;
+				}
+				aNodes[nNode].aChildren.push_back(nChild);
+			}
+			nNode = nChild;
+		}
+		if (!aNodes[nNode].bTerminal)
+		{
+			aNodes[nNode].bTerminal = true;
+			nPending++;
+		}
+		return nNode;
+	}
+
+	enum
+	{
+		WALK_INVALID,
+		WALK_CONTINUE,
+		WALK_DONE
+	};
+
+	// Consumes the value at the reader position for trie node nNode
+	int walk(json_reader &oReader, size_t nNode)
+	{
+		node &oNode = aNodes[nNode];
+		if (oNode.bTerminal && !oNode.bCaptured)
+		{
+			// Capture from a copy when the walk also has to descend into this value
+			json_reader oCapture = oReader;
+			json_reader &oSource = oNode.aChildren.empty() ? oReader : oCapture;
+			if (!json_read_ring_item(pState, oSource, pHolder, false))
+			{
+				return WALK_INVALID;
+			}
+			oNode.bCaptured = true;
+			oNode.nHolderIndex = ring_list_getsize(pHolder);
+			if (--nPending == 0)
+			{
+				return WALK_DONE;
+			}
+			if (oNode.aChildren.empty())
+			{
+				return WALK_CONTINUE;
+			}
+		}
+		if (oNode.aChildren.empty())
+		{
+			return oReader.skip_value() ? WALK_CONTINUE : WALK_INVALID;
+		}
+
+		std::string cScratch;
+		json_token nToken = oReader.next();
+		if (nToken == JSON_TOKEN_OBJECT_BEGIN)
+		{
+			for (;;)
+			{
+				nToken = oReader.next();
+				if (nToken == JSON_TOKEN_OBJECT_END)
+				{
+					return WALK_CONTINUE;
+				}
+				if (nToken != JSON_TOKEN_KEY)
+				{
+					return WALK_INVALID;
+				}
+				size_t nChild = 0;
+				for (size_t nCandidate : aNodes[nNode].aChildren)
+				{
+					if (json_reader_text_equals(oReader, aNodes[nCandidate].cToken, cScratch))
+					{
+						nChild = nCandidate;
+						break;
+					}
+				}
+				int nResult = nChild ? walk(oReader, nChild) : (oReader.skip_value() ? WALK_CONTINUE : WALK_INVALID);
+				if (nResult != WALK_CONTINUE)
+				{
+					return nResult;
+				}
+			}
+		}
+		if (nToken == JSON_TOKEN_ARRAY_BEGIN)
+		{
+			for (size_t i = 0;; i++)
+			{
+				oReader.skip_whitespace();
+				if (oReader.pCursor < oReader.pEnd && *oReader.pCursor == ']')
+				{
+					oReader.next();
+					return WALK_CONTINUE;
+				}
+				size_t nChild = 0;
+				for (size_t nCandidate : aNodes[nNode].aChildren)
+				{
+					if (aNodes[nCandidate].nIndex == i)
+					{
+						nChild = nCandidate;
+						break;
+					}
+				}
+				int nResult = nChild ? walk(oReader, nChild) : (oReader.skip_value() ? WALK_CONTINUE : WALK_INVALID);
+				if (nResult != WALK_CONTINUE)
+				{
+					return nResult;
+				}
+			}
+		}
+		return nToken == JSON_TOKEN_ERROR || nToken == JSON_TOKEN_EOF ? WALK_INVALID : WALK_CONTINUE;
+	}
+};
+
+// Appends the default value (parameter 3, or null) of json_pointer_many()
+static void json_pointer_many_default(void *pPointer, List *pResult)
+{
+	if (RING_API_PARACOUNT < 3 || RING_API_ISSTRING(3))
+	{
+		if (RING_API_PARACOUNT < 3)
+		{
+			ring_list_addstring2_gc(RING_API_STATE, pResult, RING_CSTR_EMPTY, 0);
+		}
+		else
+		{
+			ring_list_addstring2_gc(RING_API_STATE, pResult, RING_API_GETSTRING(3), RING_API_GETSTRINGSIZE(3));
+		}
+	}
+	else if (RING_API_ISNUMBER(3))
+	{
+		ring_list_adddouble_gc(RING_API_STATE, pResult, RING_API_GETNUMBER(3));
+	}
+	else
+	{
+		ring_list_copy_gc(RING_API_STATE, ring_list_newlist_gc(RING_API_STATE, pResult), RING_API_GETLIST(3));
+	}
+}
+
+RING_FUNC(ring_json_pointer_many)
+{
+	if (RING_API_PARACOUNT < 2 || RING_API_PARACOUNT > 3)
+	{
+		RING_API_ERROR(RING_API_BADPARACOUNT);
+		return;
+	}
+
+	if ((!RING_API_ISSTRING(1) && !RING_API_ISCPOINTER(1)) || !RING_API_ISLIST(2))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	if (RING_API_PARACOUNT == 3 && !RING_API_ISSTRING(3) && !RING_API_ISNUMBER(3) && !RING_API_ISLIST(3))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	List *pPaths = RING_API_GETLIST(2);
+	int nPaths = ring_list_getsize(pPaths);
+
+	json_pointer_trie oTrie;
+	std::vector<size_t> aTerminals(nPaths);
+	std::vector<std::string> tokens;
+	std::vector<std::vector<std::string>> aPathTokens;
+
+	for (int x = 1; x <= nPaths; x++)
+	{
+		if (!ring_list_isstring(pPaths, x))
+		{
+			RING_API_ERROR(RING_API_BADPARATYPE);
+			return;
+		}
+		if (!json_pointer_parse(std::string_view(ring_list_getstring(pPaths, x), ring_list_getstringsize(pPaths, x)),
+								tokens))
+		{
+			RING_API_ERROR("Invalid JSON pointer.");
+			return;
+		}
+		aTerminals[x - 1] = oTrie.add(tokens);
+		aPathTokens.push_back(tokens);
+	}
+
+	List *pResult = RING_API_NEWLIST;
+
+	if (RING_API_ISCPOINTER(1))
+	{
+		json_value *pDocument = json_document_param(pPointer, 1);
+		if (!pDocument)
+		{
+			return;
+		}
+		for (int x = 0; x < nPaths; x++)
+		{
+			const json_value *pValue = nullptr;
+			if (json_tree_seek(*pDocument, aPathTokens[x], pValue) == JSON_SEEK_FOUND)
+			{
+				json_value_to_ring_item(RING_API_STATE, *pValue, pResult);
+			}
+			else
+			{
+				json_pointer_many_default(pPointer, pResult);
+			}
+		}
+		RING_API_RETLISTBYREF(pResult);
+		return;
+	}
+
+	std::string_view jsonView = JSON_STRING_PARAM(1);
+	json_reader oReader(jsonView.data(), jsonView.data() + jsonView.size());
+	oTrie.pState = RING_API_STATE;
+	oTrie.pHolder = RING_API_NEWLIST;
+
+	if (nPaths > 0 && oTrie.walk(oReader, 0) == json_pointer_trie::WALK_INVALID)
+	{
+		RING_API_ERROR("Invalid JSON input.");
+		return;
+	}
+
+	// Move the captured values into path order; a value requested by several
+	// paths is copied after its first use
+	std::vector<List *> aPlaced(ring_list_getsize(oTrie.pHolder) + 1, nullptr);
+	for (int x = 0; x < nPaths; x++)
+	{
+		const auto &oNode = oTrie.aNodes[aTerminals[x]];
+		if (!oNode.bCaptured)
+		{
+			json_pointer_many_default(pPointer, pResult);
+			continue;
+		}
+
+		int nItem = oNode.nHolderIndex;
+		if (ring_list_islist(oTrie.pHolder, nItem))
+		{
+			List *pValue = ring_list_newlist_gc(RING_API_STATE, pResult);
+			if (aPlaced[nItem])
+			{
+				ring_list_copy_gc(RING_API_STATE, pValue, aPlaced[nItem]);
+			}
+			else
+			{
+				ring_list_swaptwolists(pValue, ring_list_getlist(oTrie.pHolder, nItem));
+				aPlaced[nItem] = pValue;
+			}
+		}
+		else if (ring_list_isstring(oTrie.pHolder, nItem))
+		{
+			ring_list_addstring2_gc(RING_API_STATE, pResult, ring_list_getstring(oTrie.pHolder, nItem),
+									ring_list_getstringsize(oTrie.pHolder, nItem));
+		}
+		else
+		{
+			ring_list_adddouble_gc(RING_API_STATE, pResult, ring_list_getdouble(oTrie.pHolder, nItem));
+		}
+	}
+
+	RING_API_RETLISTBYREF(pResult);
+}
+
+// Classifies a JSON text from its first significant byte, without reading
+// the rest of the document
+static const char *json_type_from_first_byte(std::string_view json)
+{
+	const char *p = json.data();
+	const char *pEnd = p + json.size();
+	while (p < pEnd && json_is_whitespace(*p))
+	{
+		p++;
+	}
+	if (p == pEnd)
+	{
+		return "invalid";
+	}
+	switch (*p)
+	{
+	case '{':
+		return "object";
+	case '[':
+		return "array";
+	case '"':
+		return "string";
+	case 't':
+	case 'f':
+		return "boolean";
+	case 'n':
+		return "null";
+	default:
+		return *p == '-' || json_is_digit(*p) ? "number" : "invalid";
+	}
+}
+
+// Walks the members of a root object, calling fnKey(oReader) on each key and
+// skipping the values without decoding them. bObject reports whether the root
+// is an object. Returns false when the text is not valid JSON.
+template <class KeyFn> static bool json_scan_root_keys(std::string_view json, bool &bObject, KeyFn &&fnKey)
+{
+	json_reader oReader(json.data(), json.data() + json.size());
+	json_token nToken = oReader.next();
+	bObject = nToken == JSON_TOKEN_OBJECT_BEGIN;
+	if (bObject)
+	{
+		while ((nToken = oReader.next()) != JSON_TOKEN_OBJECT_END)
+		{
+			if (nToken != JSON_TOKEN_KEY)
+			{
+				return false;
+			}
+			fnKey(oReader);
+			if (!oReader.skip_value())
+			{
+				return false;
+			}
+		}
+	}
+	else if (nToken == JSON_TOKEN_ARRAY_BEGIN)
+	{
+		if (!oReader.skip_container())
+		{
+			return false;
+		}
+	}
+	else if (nToken == JSON_TOKEN_ERROR || nToken == JSON_TOKEN_EOF)
+	{
+		return false;
+	}
+	return oReader.finish();
+}
+
+RING_FUNC(ring_json_type)
+{
+	if (RING_API_PARACOUNT < 1 || RING_API_PARACOUNT > 2)
+	{
+		RING_API_ERROR(RING_API_BADPARACOUNT);
+		return;
+	}
+
+	if ((!RING_API_ISSTRING(1) && !RING_API_ISCPOINTER(1)) || (RING_API_PARACOUNT == 2 && !RING_API_ISNUMBER(2)))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	if (RING_API_ISSTRING(1))
+	{
+		std::string_view jsonView = JSON_STRING_PARAM(1);
+		size_t nOffset;
+		if (RING_API_PARACOUNT == 2 && RING_API_GETNUMBER(2) != 0 && !json_validate(jsonView, nOffset))
+		{
+			RING_API_RETSTRING("invalid");
+			return;
+		}
+		RING_API_RETSTRING(json_type_from_first_byte(jsonView));
+		return;
+	}
+
+	const json_value *pRoot = json_document_param(pPointer, 1);
+	if (!pRoot)
+	{
+		return;
+	}
+
+	if (pRoot->get_if<json_value::object_t>())
+	{
+		RING_API_RETSTRING("object");
+	}
+	else if (pRoot->get_if<json_value::array_t>())
+	{
+		RING_API_RETSTRING("array");
+	}
+	else if (pRoot->get_if<json_value::string_t>())
+	{
+		RING_API_RETSTRING("string");
+	}
+	else if (pRoot->get_if<double>())
+	{
+		RING_API_RETSTRING("number");
+	}
+	else if (pRoot->get_if<bool>())
+	{
+		RING_API_RETSTRING("boolean");
+	}
+	else
+	{
+		RING_API_RETSTRING("null");
+	}
+}
+
+RING_FUNC(ring_json_keys)
+{
+	if (RING_API_PARACOUNT != 1)
+	{
+		RING_API_ERROR(RING_API_MISS1PARA);
+		return;
+	}
+
+	if (!RING_API_ISSTRING(1) && !RING_API_ISCPOINTER(1))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	List *pList;
+	if (RING_API_ISSTRING(1))
+	{
+		void *pState = RING_API_STATE;
+		std::string cScratch;
+		bool bObject;
+		pList = RING_API_NEWLIST;
+		// A repeated key is listed once, at its first position, as with handles
+		std::unordered_set<std::string_view> aSeen;
+		if (!json_scan_root_keys(JSON_STRING_PARAM(1), bObject, [&](const json_reader &oReader) {
+				std::string_view cKey = json_token_text(oReader, cScratch);
+				if (aSeen.count(cKey) == 0)
+				{
+					ring_list_addstring2_gc(pState, pList, cKey.data(), cKey.size());
+					int nSize = ring_list_getsize(pList);
+					aSeen.emplace(ring_list_getstring(pList, nSize), ring_list_getstringsize(pList, nSize));
+				}
+			}))
+		{
+			RING_API_ERROR("Invalid JSON input.");
+			return;
+		}
+		if (!bObject)
+		{
+			RING_API_ERROR("JSON value is not an object.");
+			return;
+		}
+		RING_API_RETLISTBYREF(pList);
+		return;
+	}
+
+	const json_value *pRoot = json_document_param(pPointer, 1);
+	if (!pRoot)
+	{
+		return;
+	}
+
+	auto *obj = pRoot->get_if<json_value::object_t>();
+	if (!obj)
+	{
+		RING_API_ERROR("JSON value is not an object.");
+		return;
+	}
+
+	pList = RING_API_NEWLIST;
+	for (const auto &[key, val] : *obj)
+	{
+		ring_list_addstring2_gc(RING_API_STATE, pList, key.data(), key.size());
+	}
+
+	RING_API_RETLISTBYREF(pList);
+}
+
+RING_FUNC(ring_json_has)
+{
+	if (RING_API_PARACOUNT != 2)
+	{
+		RING_API_ERROR(RING_API_MISS2PARA);
+		return;
+	}
+
+	if ((!RING_API_ISSTRING(1) && !RING_API_ISCPOINTER(1)) || !RING_API_ISSTRING(2))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	std::string_view cKey = JSON_STRING_PARAM(2);
+
+	if (RING_API_ISSTRING(1))
+	{
+		std::string cScratch;
+		bool bObject;
+		bool bFound = false;
+		bool bValid = json_scan_root_keys(JSON_STRING_PARAM(1), bObject, [&](const json_reader &oReader) {
+			if (!bFound && oReader.bEscaped)
+			{
+				json_unescape(oReader.text(), cScratch);
+				bFound = cScratch == cKey;
+			}
+			else if (!bFound)
+			{
+				bFound = oReader.text() == cKey;
+			}
+		});
+		RING_API_RETNUMBER(bValid && bFound ? 1.0 : 0.0);
+		return;
+	}
+
+	const json_value *pRoot = json_document_param(pPointer, 1);
+	if (!pRoot)
+	{
+		return;
+	}
+
+	auto *obj = pRoot->get_if<json_value::object_t>();
+	if (!obj)
+	{
+		RING_API_RETNUMBER(0.0);
+		return;
+	}
+
+	RING_API_RETNUMBER(obj->find(cKey) != obj->end() ? 1.0 : 0.0);
+}
+
+RING_FUNC(ring_json_merge)
+{
+	if (RING_API_PARACOUNT != 2)
 	{
-		RING_API_RETNUMBER(0.0);
+		RING_API_ERROR(RING_API_MISS2PARA);
+		return;
+	}
+
+	if (!RING_API_ISSTRING(1) || !RING_API_ISSTRING(2))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	std::string_view cJson1 = JSON_STRING_PARAM(1);
+	std::string_view cJson2 = JSON_STRING_PARAM(2);
+
+	json_tree_arena oArena;
+	json_value json1(oArena.resource()), json2(oArena.resource());
+	std::string cError;
+
+	if (!json_tree_load(cJson1, json1, cError))
+	{
+		RING_API_ERROR("Invalid JSON in first argument.");
+		return;
+	}
+
+	if (!json_tree_load(cJson2, json2, cError))
+	{
+		RING_API_ERROR("Invalid JSON in second argument.");
+		return;
+	}
+
+	auto *obj1 = json1.get_if<json_value::object_t>();
+	auto *obj2 = json2.get_if<json_value::object_t>();
+
+	if (!obj1 || !obj2)
+	{
+		RING_API_ERROR("Both arguments must be JSON objects.");
 		return;
 	}
-	RING_API_RETNUMBER(strcmp(RING_API_GETSTRING(1), "__JSON_FALSE__") == 0 ? 1.0 : 0.0);
+
+	// Keys of the first object keep their place; new keys are appended
+	for (auto &[key, val] : *obj2)
+	{
+		(*obj1)[key] = std::move(val);
+	}
+
+	json_output_buffer oOutput;
+	std::string &result = oOutput.str();
+	json_tree_write(result, json1);
+
+	RING_API_RETSTRING2(result.data(), result.size());
 }
 
-RING_FUNC(ring_json_tobool)
+// Whole contents of a file, memory-mapped when possible and read with one bulk
+// read otherwise. The byte after the contents is always a readable NUL: a
+// mapping is only used when the file does not end on a page boundary, so the
+// zero-filled tail of its last page serves as the terminator glaze expects.
+class json_file_view
+{
+  public:
+	json_file_view() = default;
+	json_file_view(const json_file_view &) = delete;
+	json_file_view &operator=(const json_file_view &) = delete;
+
+	~json_file_view()
+	{
+#ifndef _WIN32
+		if (pMapping)
+		{
+			munmap(pMapping, nSize);
+		}
+#endif
+	}
+
+	bool open(const char *cPath)
+	{
+#ifndef _WIN32
+		int nFile = ::open(cPath, O_RDONLY);
+		if (nFile < 0)
+		{
+			return false;
+		}
+		struct stat oStat;
+		bool bMapped = false;
+		size_t nExpected = 0;
+		if (fstat(nFile, &oStat) == 0 && S_ISREG(oStat.st_mode) && oStat.st_size > 0)
+		{
+			size_t nFileSize = (size_t)oStat.st_size;
+			long nPageSize = sysconf(_SC_PAGESIZE);
+			if (nPageSize > 0 && nFileSize % (size_t)nPageSize != 0)
+			{
+				void *pData = mmap(nullptr, nFileSize, PROT_READ, MAP_PRIVATE, nFile, 0);
+				if (pData != MAP_FAILED)
+				{
+#ifdef MADV_SEQUENTIAL
+					madvise(pData, nFileSize, MADV_SEQUENTIAL);
+#endif
+					pMapping = pData;
+					nSize = nFileSize;
+					bMapped = true;
+				}
+			}
+			nExpected = nFileSize;
+		}
+		bool bResult = bMapped || read_all(nFile, nExpected);
+		::close(nFile);
+		return bResult;
+#else
+		FILE *pFile = fopen(cPath, "rb");
+		if (!pFile)
+		{
+			return false;
+		}
+		bool bResult = true;
+		if (fseek(pFile, 0, SEEK_END) == 0)
+		{
+			long nFileSize = ftell(pFile);
+			if (nFileSize > 0)
+			{
+				cBuffer.resize((size_t)nFileSize);
+				rewind(pFile);
+				cBuffer.resize(fread(&cBuffer[0], 1, cBuffer.size(), pFile));
+				bResult = !ferror(pFile);
+			}
+		}
+		fclose(pFile);
+		return bResult;
+#endif
+	}
+
+	std::string_view view() const
+	{
+		if (pMapping)
+		{
+			return std::string_view((const char *)pMapping, nSize);
+		}
+		return cBuffer;
+	}
+
+  private:
+	void *pMapping = nullptr;
+	size_t nSize = 0;
+	std::string cBuffer;
+
+#ifndef _WIN32
+	// Reads until end of file. The spare byte lets a file of the expected size
+	// reach end of file without growing; pipes and other unsized files grow
+	bool read_all(int nFile, size_t nExpected)
+	{
+		size_t nUsed = 0;
+		cBuffer.resize(nExpected ? nExpected + 1 : 65536);
+		for (;;)
+		{
+			if (nUsed == cBuffer.size())
+			{
+				cBuffer.resize(cBuffer.size() * 2);
+			}
+			ssize_t nRead = ::read(nFile, &cBuffer[nUsed], cBuffer.size() - nUsed);
+			if (nRead < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				return false;
+			}
+			if (nRead == 0)
+			{
+				break;
+			}
+			nUsed += (size_t)nRead;
+		}
+		cBuffer.resize(nUsed);
+		return true;
+	}
+#endif
+};
+
+RING_FUNC(ring_json_read_file)
+{
+	if (RING_API_PARACOUNT != 1)
+	{
+		RING_API_ERROR(RING_API_MISS1PARA);
+		return;
+	}
+
+	if (!RING_API_ISSTRING(1))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	json_file_view oFile;
+	if (!oFile.open(RING_API_GETSTRING(1)))
+	{
+		RING_API_ERROR("Cannot open file for reading.");
+		return;
+	}
+
+	List *pList = json_text_to_ring_list(pPointer, oFile.view());
+	if (pList)
+	{
+		RING_API_RETLISTBYREF(pList);
+	}
+}
+
+RING_FUNC(ring_json_write_file)
+{
+	if (RING_API_PARACOUNT < 2 || RING_API_PARACOUNT > 4)
+	{
+		RING_API_ERROR(RING_API_BADPARACOUNT);
+		return;
+	}
+
+	if (!RING_API_ISLIST(1) || !RING_API_ISSTRING(2))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	if (RING_API_ISOBJECT(1))
+	{
+		RING_API_ERROR("Cannot encode a Ring object directly to JSON.");
+		return;
+	}
+
+	bool prettyPrint = false;
+	if (RING_API_PARACOUNT >= 3 && RING_API_ISNUMBER(3))
+	{
+		prettyPrint = (RING_API_GETNUMBER(3) == 1.0);
+	}
+
+	bool bSync = false;
+	if (RING_API_PARACOUNT == 4 && RING_API_ISNUMBER(4))
+	{
+		bSync = (RING_API_GETNUMBER(4) == 1.0);
+	}
+
+	List *pList = RING_API_GETLIST(1);
+	const char *cFilePath = RING_API_GETSTRING(2);
+
+	json_file_sink oSink;
+	if (!oSink.open(cFilePath))
+	{
+		RING_API_ERROR("Cannot open file for writing.");
+		return;
+	}
+
+	json_output_buffer oOutput;
+	std::string &jsonString = oOutput.str();
+	jsonString.reserve(JSON_WRITE_CHUNK_SIZE * 2);
+	ring_json_writer oWriter(jsonString, prettyPrint);
+	oWriter.pSink = &oSink;
+	oWriter.write_list(pList);
+
+	if (oWriter.bSinkFailed || !oSink.write(jsonString.data(), jsonString.size()) || !oSink.commit(bSync))
+	{
+		RING_API_ERROR("Failed to write file.");
+		return;
+	}
+
+	RING_API_RETNUMBER(1.0);
+}
+
+RING_FUNC(ring_json_to_beve)
+{
+	if (RING_API_PARACOUNT != 1)
+	{
+		RING_API_ERROR(RING_API_MISS1PARA);
+		return;
+	}
+
+	if (!RING_API_ISSTRING(1))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	std::string_view jsonView = JSON_STRING_PARAM(1);
+
+	glz::generic jsonRoot;
+	auto ec = glz::read_json(jsonRoot, jsonView);
+	if (ec)
+	{
+		RING_API_ERROR("Invalid JSON input.");
+		return;
+	}
+
+	json_output_buffer oOutput;
+	std::string &beveData = oOutput.str();
+	auto ec2 = glz::write_beve(jsonRoot, beveData);
+	if (ec2)
+	{
+		RING_API_ERROR("Failed to convert to BEVE.");
+		return;
+	}
+
+	RING_API_RETSTRING2(beveData.data(), beveData.size());
+}
+
+RING_FUNC(ring_beve_to_json)
 {
 	if (RING_API_PARACOUNT != 1)
 	{
-		RING_API_ERROR(RING_API_MISS1PARA);
+		RING_API_ERROR(RING_API_MISS1PARA);
+		return;
+	}
+
+	if (!RING_API_ISSTRING(1))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	std::string_view beveView = JSON_STRING_PARAM(1);
+
+	glz::generic jsonRoot;
+	auto ec = glz::read_beve(jsonRoot, beveView);
+	if (ec)
+	{
+		RING_API_ERROR("Invalid BEVE input.");
+		return;
+	}
+
+	json_output_buffer oOutput;
+	std::string &jsonString = oOutput.str();
+	auto ec2 = glz::write_json(jsonRoot, jsonString);
+	if (ec2)
+	{
+		RING_API_ERROR("Failed to convert to JSON.");
+		return;
+	}
+
+	RING_API_RETSTRING2(jsonString.data(), jsonString.size());
+}
+
+// ============================================================================
+// JSON Patch (RFC 6902)
+// ============================================================================
+
+RING_FUNC(ring_json_patch)
+{
+	if (RING_API_PARACOUNT != 2)
+	{
+		RING_API_ERROR(RING_API_MISS2PARA);
+		return;
+	}
+
+	if (!RING_API_ISSTRING(1) || !RING_API_ISSTRING(2))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	std::string_view cDocJson = JSON_STRING_PARAM(1);
+	std::string_view cPatchJson = JSON_STRING_PARAM(2);
+
+	auto result = glz::patch_json(cDocJson, cPatchJson);
+	if (!result)
+	{
+		RING_API_ERROR("Failed to apply JSON patch.");
+		return;
+	}
+
+	RING_API_RETSTRING2(result->data(), result->size());
+}
+
+RING_FUNC(ring_json_diff)
+{
+	if (RING_API_PARACOUNT != 2)
+	{
+		RING_API_ERROR(RING_API_MISS2PARA);
+		return;
+	}
+
+	if (!RING_API_ISSTRING(1) || !RING_API_ISSTRING(2))
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
+	}
+
+	std::string_view cSourceJson = JSON_STRING_PARAM(1);
+	std::string_view cTargetJson = JSON_STRING_PARAM(2);
+
+	auto patch = glz::diff(cSourceJson, cTargetJson);
+	if (!patch)
+	{
+		RING_API_ERROR("Failed to generate JSON diff.");
 		return;
 	}
-	if (RING_API_ISSTRING(1))
+
+	json_output_buffer oOutput;
+	std::string &patchJson = oOutput.str();
+	auto ec = glz::write_json(*patch, patchJson);
+	if (ec)
 	{
-		const char *s = RING_API_GETSTRING(1);
-		if (strcmp(s, "__JSON_TRUE__") == 0)
-		{
-			RING_API_RETNUMBER(1.0);
-			return;
-		}
-		if (strcmp(s, "__JSON_FALSE__") == 0)
-		{
-			RING_API_RETNUMBER(0.0);
-			return;
-		}
+		RING_API_ERROR("Failed to serialize JSON patch.");
+		return;
 	}
-	RING_API_ERROR("Not a JSON boolean value.");
+
+	RING_API_RETSTRING2(patchJson.data(), patchJson.size());
 }
 
-RING_FUNC(ring_json_valid)
+// ============================================================================
+// JSON Merge Patch (RFC 7386)
+// ============================================================================
+
+RING_FUNC(ring_json_merge_patch)
 {
-	if (RING_API_PARACOUNT != 1)
+	if (RING_API_PARACOUNT != 2)
 	{
-		RING_API_ERROR(RING_API_MISS1PARA);
+		RING_API_ERROR(RING_API_MISS2PARA);
 		return;
 	}
 
-	if (!RING_API_ISSTRING(1))
+	if (!RING_API_ISSTRING(1) || !RING_API_ISSTRING(2))
 	{
 		RING_API_ERROR(RING_API_BADPARATYPE);
 		return;
 	}
 
-	const char *cJsonString = RING_API_GETSTRING(1);
-	std::string_view jsonView(cJsonString);
+	std::string_view cTargetJson = JSON_STRING_PARAM(1);
+	std::string_view cPatchJson = JSON_STRING_PARAM(2);
 
-	glz::generic temp;
-	auto ec = glz::read_json(temp, jsonView);
+	auto result = glz::merge_patch_json(cTargetJson, cPatchJson);
+	if (!result)
+	{
+		RING_API_ERROR("Failed to apply merge patch.");
+		return;
+	}
 
-	RING_API_RETNUMBER(ec ? 0.0 : 1.0);
+	RING_API_RETSTRING2(result->data(), result->size());
 }
 
-RING_FUNC(ring_json_minify)
+RING_FUNC(ring_json_merge_diff)
 {
-	if (RING_API_PARACOUNT != 1)
+	if (RING_API_PARACOUNT != 2)
 	{
-		RING_API_ERROR(RING_API_MISS1PARA);
+		RING_API_ERROR(RING_API_MISS2PARA);
 		return;
 	}
 
-	if (!RING_API_ISSTRING(1))
+	if (!RING_API_ISSTRING(1) || !RING_API_ISSTRING(2))
 	{
 		RING_API_ERROR(RING_API_BADPARATYPE);
 		return;
 	}
 
-	const char *cJsonString = RING_API_GETSTRING(1);
-	std::string input(cJsonString);
-	std::string result = glz::minify_json(input);
+	std::string_view cSourceJson = JSON_STRING_PARAM(1);
+	std::string_view cTargetJson = JSON_STRING_PARAM(2);
 
-	if (result.empty() && !input.empty())
+	auto patch = glz::merge_diff_json(cSourceJson, cTargetJson);
+	if (!patch)
 	{
-		RING_API_ERROR("Failed to minify JSON.");
+		RING_API_ERROR("Failed to generate merge diff.");
 		return;
 	}
 
-	RING_API_RETSTRING(result.c_str());
+	RING_API_RETSTRING2(patch->data(), patch->size());
 }
 
-RING_FUNC(ring_json_prettify)
+// ============================================================================
+// CBOR (Concise Binary Object Representation)
+// ============================================================================
+
+RING_FUNC(ring_json_to_cbor)
 {
-	if (RING_API_PARACOUNT < 1 || RING_API_PARACOUNT > 2)
+	if (RING_API_PARACOUNT != 1)
 	{
-		RING_API_ERROR(RING_API_BADPARACOUNT);
+		RING_API_ERROR(RING_API_MISS1PARA);
 		return;
 	}
 
@@ -424,314 +4276,785 @@ RING_FUNC(ring_json_prettify)
 		return;
 	}
 
-	const char *cJsonString = RING_API_GETSTRING(1);
-	std::string input(cJsonString);
-	std::string result = glz::prettify_json(input);
+	std::string_view jsonView = JSON_STRING_PARAM(1);
+
+	glz::generic jsonRoot;
+	auto ec = glz::read_json(jsonRoot, jsonView);
+	if (ec)
+	{
+		RING_API_ERROR("Invalid JSON input.");
+		return;
+	}
 
-	if (result.empty() && !input.empty())
+	json_output_buffer oOutput;
+	std::string &cborData = oOutput.str();
+	auto ec2 = glz::write_cbor(jsonRoot, cborData);
+	if (ec2)
 	{
-		RING_API_ERROR("Failed to prettify JSON.");
+		RING_API_ERROR("Failed to convert to CBOR.");
 		return;
 	}
 
-	RING_API_RETSTRING(result.c_str());
+	RING_API_RETSTRING2(cborData.data(), cborData.size());
 }
 
-RING_FUNC(ring_json_pointer)
+RING_FUNC(ring_cbor_to_json)
 {
-	if (RING_API_PARACOUNT != 2)
+	if (RING_API_PARACOUNT != 1)
 	{
-		RING_API_ERROR(RING_API_MISS2PARA);
+		RING_API_ERROR(RING_API_MISS1PARA);
 		return;
 	}
 
-	if (!RING_API_ISSTRING(1) || !RING_API_ISSTRING(2))
+	if (!RING_API_ISSTRING(1))
 	{
 		RING_API_ERROR(RING_API_BADPARATYPE);
 		return;
 	}
 
-	const char *cJsonString = RING_API_GETSTRING(1);
-	const char *cPointer = RING_API_GETSTRING(2);
+	std::string_view cborView = JSON_STRING_PARAM(1);
 
-	std::string_view jsonView(cJsonString);
-
-	glz::generic result;
-	auto ec = glz::read_json(result, jsonView);
+	glz::generic jsonRoot;
+	auto ec = glz::read_cbor(jsonRoot, cborView);
 	if (ec)
 	{
-		RING_API_ERROR("Invalid JSON input.");
+		RING_API_ERROR("Invalid CBOR input.");
 		return;
 	}
 
-	auto *current = &result;
-	std::string pointer(cPointer);
-
-	if (!pointer.empty() && pointer[0] == '/')
+	json_output_buffer oOutput;
+	std::string &jsonString = oOutput.str();
+	auto ec2 = glz::write_json(jsonRoot, jsonString);
+	if (ec2)
 	{
-		pointer = pointer.substr(1);
+		RING_API_ERROR("Failed to convert to JSON.");
+		return;
 	}
 
-	std::vector<std::string> tokens;
-	size_t pos = 0;
-	while ((pos = pointer.find('/')) != std::string::npos)
+	RING_API_RETSTRING2(jsonString.data(), jsonString.size());
+}
+
+// ============================================================================
+// NDJSON (Newline Delimited JSON / JSON Lines)
+// ============================================================================
+
+// Decodes one record per non-blank line into a new sub-list of pResultList
+static bool json_ndjson_to_ring(void *pState, std::string_view ndjsonView, List *pResultList)
+{
+	const char *p = ndjsonView.data();
+	const char *pEnd = p + ndjsonView.size();
+
+	while (p < pEnd)
 	{
-		tokens.push_back(pointer.substr(0, pos));
-		pointer.erase(0, pos + 1);
+		const char *pLineEnd = static_cast<const char *>(memchr(p, '\n', pEnd - p));
+		if (!pLineEnd)
+		{
+			pLineEnd = pEnd;
+		}
+
+		json_reader oReader(p, pLineEnd);
+		oReader.skip_whitespace();
+		if (oReader.pCursor < pLineEnd)
+		{
+			List *pRecord = ring_list_newlist_gc(pState, pResultList);
+			if (!json_read_ring_item(pState, oReader, pRecord, true) || !oReader.finish())
+			{
+				return false;
+			}
+		}
+		p = pLineEnd + 1;
 	}
-	if (!pointer.empty())
+	return true;
+}
+
+// ============================================================================
+// Worker Threads
+// ============================================================================
+
+// Inputs smaller than this are always handled on the calling thread
+constexpr size_t JSON_PARALLEL_MIN_BYTES = 1024 * 1024;
+constexpr int JSON_PARALLEL_MIN_RECORDS = 1024;
+
+// Upper bound on worker threads, as a multiple of the number of cores
+constexpr size_t JSON_THREADS_PER_CORE_MAX = 4;
+
+// Number of worker threads for a user supplied thread count (0 = one per core)
+static size_t json_thread_count(double nRequested)
+{
+	unsigned int nCores = std::thread::hardware_concurrency();
+	size_t nDefault = nCores ? nCores : 1;
+	if (nRequested >= 1)
 	{
-		tokens.push_back(pointer);
+		double nMax = (double)(nDefault * JSON_THREADS_PER_CORE_MAX);
+		return nRequested < nMax ? (size_t)nRequested : (size_t)nMax;
 	}
+	return nDefault;
+}
 
-	for (const auto &token : tokens)
-	{
-		if (auto *obj = current->get_if<glz::generic::object_t>())
+// Runs fnTask(0) .. fnTask(nTasks - 1) on up to nThreads threads, the calling
+// thread included. Workers must not touch the Ring VM. Returns false if a task
+// threw (e.g. std::bad_alloc). If a thread cannot be started, the tasks are
+// shared by the threads already running.
+template <class Task> static bool json_parallel_for(size_t nTasks, size_t nThreads, const Task &fnTask)
+{
+	std::atomic<size_t> nNext{0};
+	std::atomic<bool> bFailed{false};
+	auto fnWorker = [&]() {
+		try
 		{
-			auto it = obj->find(token);
-			if (it == obj->end())
+			for (size_t i = nNext++; i < nTasks && !bFailed; i = nNext++)
 			{
-				RING_API_ERROR("JSON pointer path not found.");
-				return;
+				fnTask(i);
 			}
-			current = &(it->second);
 		}
-		else if (auto *arr = current->get_if<glz::generic::array_t>())
+		catch (...)
 		{
-			size_t index = std::stoull(token);
-			if (index >= arr->size())
-			{
-				RING_API_ERROR("JSON pointer index out of range.");
-				return;
-			}
-			current = &((*arr)[index]);
+			bFailed = true;
+		}
+	};
+
+	std::vector<std::thread> aThreads;
+	try
+	{
+		for (size_t i = 1; i < std::min(nThreads, nTasks); i++)
+		{
+			aThreads.emplace_back(fnWorker);
+		}
+	}
+	catch (...)
+	{
+		// std::system_error or std::bad_alloc: carry on with fewer threads
+	}
+	fnWorker();
+	for (auto &oThread : aThreads)
+	{
+		oThread.join();
+	}
+	return !bFailed;
+}
+
+// Splits text into about nChunks pieces that end at newline boundaries
+static std::vector<std::string_view> json_split_lines(std::string_view cText, size_t nChunks)
+{
+	std::vector<std::string_view> aChunks;
+	size_t nTarget = cText.size() / nChunks + 1;
+	size_t nStart = 0;
+	while (nStart < cText.size())
+	{
+		size_t nEnd = nStart + nTarget;
+		if (nEnd >= cText.size())
+		{
+			nEnd = cText.size();
 		}
 		else
 		{
-			RING_API_ERROR("JSON pointer path not found.");
-			return;
+			const char *pNewLine =
+				static_cast<const char *>(memchr(cText.data() + nEnd, '\n', cText.size() - nEnd));
+			nEnd = pNewLine ? (size_t)(pNewLine - cText.data()) + 1 : cText.size();
 		}
+		aChunks.push_back(cText.substr(nStart, nEnd - nStart));
+		nStart = nEnd;
 	}
+	return aChunks;
+}
 
-	List *pTempList = RING_API_NEWLIST;
-	json_value_to_ring_item(RING_API_STATE, *current, pTempList);
+// ============================================================================
+// Token Tapes
+// ============================================================================
+
+// A JSON token recorded by a worker thread, with strings already unescaped
+// and numbers already converted
+struct json_tape_entry
+{
+	json_token nToken;
+	bool bOwned; // text lives in json_tape::cStrings rather than in the input
+	size_t nSize;
+	union {
+		const char *pText;
+		size_t nOffset;
+		double nNumber;
+	};
+};
+
+// The token stream of a run of JSON values, built off the VM thread and
+// replayed into Ring lists on it
+struct json_tape
+{
+	std::vector<json_tape_entry> aEntries;
+	std::string cStrings;
+	size_t nValues = 0;
+
+	void add(json_token nToken, const char *pText = nullptr, size_t nSize = 0)
+	{
+		json_tape_entry oEntry;
+		oEntry.nToken = nToken;
+		oEntry.bOwned = false;
+		oEntry.nSize = nSize;
+		oEntry.pText = pText;
+		aEntries.push_back(oEntry);
+	}
+
+	void add_number(double nNumber)
+	{
+		add(JSON_TOKEN_NUMBER);
+		aEntries.back().nNumber = nNumber;
+	}
+
+	// Records the next complete value of oReader
+	bool record(json_reader &oReader)
+	{
+		size_t nDepth = 0;
+		std::string cScratch;
+		do
+		{
+			add(oReader.next());
+			json_tape_entry &oEntry = aEntries.back();
+			switch (oEntry.nToken)
+			{
+			case JSON_TOKEN_OBJECT_BEGIN:
+			case JSON_TOKEN_ARRAY_BEGIN:
+				nDepth++;
+				break;
+			case JSON_TOKEN_OBJECT_END:
+			case JSON_TOKEN_ARRAY_END:
+				nDepth--;
+				break;
+			case JSON_TOKEN_KEY:
+			case JSON_TOKEN_STRING:
+				if (oReader.bEscaped)
+				{
+					json_unescape(oReader.text(), cScratch);
+					oEntry.bOwned = true;
+					oEntry.nOffset = cStrings.size();
+					oEntry.nSize = cScratch.size();
+					cStrings += cScratch;
+				}
+				else
+				{
+					oEntry.pText = oReader.pText;
+					oEntry.nSize = oReader.nTextSize;
+				}
+				break;
+			case JSON_TOKEN_NUMBER:
+				oEntry.nNumber = oReader.number();
+				break;
+			case JSON_TOKEN_TRUE:
+			case JSON_TOKEN_FALSE:
+			case JSON_TOKEN_NULL:
+				break;
+			default:
+				return false;
+			}
+		} while (nDepth > 0);
+		nValues++;
+		return true;
+	}
+};
+
+// Replays a json_tape with the interface json_read_ring_item expects
+struct json_tape_reader
+{
+	const json_tape &oTape;
+	size_t nIndex = 0;
+	bool bEscaped = false; // tape strings are stored unescaped
+	const char *pText = nullptr;
+	size_t nTextSize = 0;
+	double nNumber = 0.0;
+
+	explicit json_tape_reader(const json_tape &oSource) : oTape(oSource)
+	{
+	}
 
-	if (ring_list_getsize(pTempList) == 1)
+	json_token next()
 	{
-		if (ring_list_islist(pTempList, 1))
+		const json_tape_entry &oEntry = oTape.aEntries[nIndex++];
+		if (oEntry.nToken == JSON_TOKEN_NUMBER)
 		{
-			List *pResultList = ring_list_getlist(pTempList, 1);
-			List *pFinalList = RING_API_NEWLIST;
-			ring_list_swaptwolists(pFinalList, pResultList);
-			RING_API_RETLISTBYREF(pFinalList);
+			nNumber = oEntry.nNumber;
 		}
-		else if (ring_list_isstring(pTempList, 1))
+		else if (oEntry.nToken == JSON_TOKEN_KEY || oEntry.nToken == JSON_TOKEN_STRING)
 		{
-			RING_API_RETSTRING(ring_list_getstring(pTempList, 1));
+			pText = oEntry.bOwned ? oTape.cStrings.data() + oEntry.nOffset : oEntry.pText;
+			nTextSize = oEntry.nSize;
 		}
-		else if (ring_list_isnumber(pTempList, 1))
+		return oEntry.nToken;
+	}
+
+	std::string_view text() const
+	{
+		return std::string_view(pText, nTextSize);
+	}
+
+	double number() const
+	{
+		return nNumber;
+	}
+};
+
+static void json_tape_record_list(json_tape &oTape, List *pList, std::vector<List *> &aAncestors);
+
+// Records a Ring item as ring_json_writer would write it (VM thread side of
+// the parallel encoders). Strings are referenced, not copied, so the tape must
+// not outlive the call that built it.
+static void json_tape_record_item(json_tape &oTape, Item *pItem, std::vector<List *> &aAncestors)
+{
+	switch (ring_item_gettype(pItem))
+	{
+	case ITEMTYPE_STRING: {
+		String *pString = ring_item_getstring(pItem);
+		json_token nToken = json_ring_string_token(ring_string_get(pString), ring_string_size(pString));
+		if (nToken == JSON_TOKEN_STRING)
 		{
-			RING_API_RETNUMBER(ring_list_getdouble(pTempList, 1));
+			oTape.add(nToken, ring_string_get(pString), ring_string_size(pString));
 		}
 		else
 		{
-			RING_API_RETLISTBYREF(pTempList);
+			oTape.add(nToken);
 		}
+		return;
 	}
-	else
-	{
-		RING_API_RETLISTBYREF(pTempList);
+	case ITEMTYPE_NUMBER:
+		oTape.add_number(ring_item_getnumber(pItem));
+		return;
+	case ITEMTYPE_LIST:
+		break;
+	default:
+		oTape.add(JSON_TOKEN_NULL);
+		return;
 	}
+
+	json_tape_record_list(oTape, ring_item_getlist(pItem), aAncestors);
 }
 
-RING_FUNC(ring_json_type)
+// Records a Ring list as an object or array, the way ring_json_writer decides
+static void json_tape_record_list(json_tape &oTape, List *pList, std::vector<List *> &aAncestors)
 {
-	if (RING_API_PARACOUNT != 1)
+	if (std::find(aAncestors.begin(), aAncestors.end(), pList) != aAncestors.end())
 	{
-		RING_API_ERROR(RING_API_MISS1PARA);
+		oTape.add(JSON_TOKEN_NULL);
 		return;
 	}
+	aAncestors.push_back(pList);
 
-	if (!RING_API_ISSTRING(1))
+	int nSize = ring_list_getsize(pList);
+	if (IS_JSON_EMPTY_OBJECT(pList))
 	{
-		RING_API_ERROR(RING_API_BADPARATYPE);
-		return;
+		oTape.add(JSON_TOKEN_OBJECT_BEGIN);
+		oTape.add(JSON_TOKEN_OBJECT_END);
+	}
+	else if (is_ring_list_a_json_object(pList))
+	{
+		oTape.add(JSON_TOKEN_OBJECT_BEGIN);
+		for (int x = 1; x <= nSize; x++)
+		{
+			List *pSubList = ring_list_getlist(pList, x);
+			String *pKey = ring_item_getstring(ring_list_getitem(pSubList, 1));
+			oTape.add(JSON_TOKEN_KEY, ring_string_get(pKey), ring_string_size(pKey));
+			json_tape_record_item(oTape, ring_list_getitem(pSubList, 2), aAncestors);
+		}
+		oTape.add(JSON_TOKEN_OBJECT_END);
+	}
+	else
+	{
+		oTape.add(JSON_TOKEN_ARRAY_BEGIN);
+		for (int x = 1; x <= nSize; x++)
+		{
+			json_tape_record_item(oTape, ring_list_getitem(pList, x), aAncestors);
+		}
+		oTape.add(JSON_TOKEN_ARRAY_END);
 	}
 
-	const char *cJsonString = RING_API_GETSTRING(1);
-	std::string_view jsonView(cJsonString);
+	aAncestors.pop_back();
+}
 
-	glz::generic jsonRoot;
-	auto ec = glz::read_json(jsonRoot, jsonView);
-	if (ec)
+// Writes the next value of oReader as compact JSON
+static void json_write_tape_value(std::string &cOut, json_tape_reader &oReader)
+{
+	size_t nDepth = 0;
+	bool bComma = false;
+	do
 	{
-		RING_API_RETSTRING("invalid");
-		return;
-	}
+		json_token nToken = oReader.next();
+		if (bComma && nToken != JSON_TOKEN_OBJECT_END && nToken != JSON_TOKEN_ARRAY_END)
+		{
+			cOut += ',';
+		}
+		bComma = true;
+		switch (nToken)
+		{
+		case JSON_TOKEN_OBJECT_BEGIN:
+			cOut += '{';
+			nDepth++;
+			bComma = false;
+			break;
+		case JSON_TOKEN_ARRAY_BEGIN:
+			cOut += '[';
+			nDepth++;
+			bComma = false;
+			break;
+		case JSON_TOKEN_OBJECT_END:
+			cOut += '}';
+			nDepth--;
+			break;
+		case JSON_TOKEN_ARRAY_END:
+			cOut += ']';
+			nDepth--;
+			break;
+		case JSON_TOKEN_KEY:
+			json_write_string(cOut, oReader.pText, oReader.nTextSize);
+			cOut += ':';
+			bComma = false;
+			break;
+		case JSON_TOKEN_STRING:
+			json_write_string(cOut, oReader.pText, oReader.nTextSize);
+			break;
+		case JSON_TOKEN_NUMBER:
+			json_write_number(cOut, oReader.number());
+			break;
+		case JSON_TOKEN_TRUE:
+			cOut += "true";
+			break;
+		case JSON_TOKEN_FALSE:
+			cOut += "false";
+			break;
+		default:
+			cOut += "null";
+			break;
+		}
+	} while (nDepth > 0);
+}
+
+// Records one NDJSON record per non-blank line of cChunk (worker thread side
+// of json_ndjson_to_ring)
+static bool json_ndjson_to_tape(std::string_view cChunk, json_tape &oTape)
+{
+	const char *p = cChunk.data();
+	const char *pEnd = p + cChunk.size();
 
-	if (jsonRoot.get_if<glz::generic::object_t>())
+	while (p < pEnd)
 	{
-		RING_API_RETSTRING("object");
+		const char *pLineEnd = static_cast<const char *>(memchr(p, '\n', pEnd - p));
+		if (!pLineEnd)
+		{
+			pLineEnd = pEnd;
+		}
+
+		json_reader oReader(p, pLineEnd);
+		oReader.skip_whitespace();
+		if (oReader.pCursor < pLineEnd && (!oTape.record(oReader) || !oReader.finish()))
+		{
+			return false;
+		}
+		p = pLineEnd + 1;
 	}
-	else if (jsonRoot.get_if<glz::generic::array_t>())
+	return true;
+}
+
+// Parallel json_ndjson_to_ring: chunks are scanned into tapes on worker
+// threads, then replayed into pResultList in input order on this thread
+static bool json_ndjson_to_ring_parallel(void *pState, std::string_view ndjsonView, List *pResultList,
+										 size_t nThreads)
+{
+	std::vector<std::string_view> aChunks = json_split_lines(ndjsonView, nThreads * 4);
+	std::vector<json_tape> aTapes(aChunks.size());
+	std::vector<char> aValid(aChunks.size(), 0);
+
+	bool bDone = json_parallel_for(aChunks.size(), nThreads,
+								   [&](size_t i) { aValid[i] = json_ndjson_to_tape(aChunks[i], aTapes[i]); });
+	if (!bDone || std::find(aValid.begin(), aValid.end(), 0) != aValid.end())
 	{
-		RING_API_RETSTRING("array");
+		return false;
 	}
-	else if (jsonRoot.get_if<std::string>())
+
+	for (auto &oTape : aTapes)
 	{
-		RING_API_RETSTRING("string");
+		json_tape_reader oReader(oTape);
+		for (size_t i = 0; i < oTape.nValues; i++)
+		{
+			json_read_ring_item(pState, oReader, ring_list_newlist_gc(pState, pResultList), true);
+		}
+		oTape = json_tape();
+	}
+	return true;
+}
+
+// Parallel NDJSON encoding of pList: the records are snapshotted into tapes
+// on this thread, and the tapes serialized on worker threads
+static bool json_ndjson_encode_parallel(List *pList, size_t nThreads, std::string &cOut)
+{
+	int nRecords = ring_list_getsize(pList);
+	size_t nChunks = std::min((size_t)nRecords, nThreads * 4);
+	std::vector<json_tape> aTapes(nChunks);
+	std::vector<List *> aAncestors;
+	for (size_t i = 0; i < nChunks; i++)
+	{
+		int nFirst = (int)(nRecords * i / nChunks) + 1;
+		int nLast = (int)(nRecords * (i + 1) / nChunks);
+		for (int x = nFirst; x <= nLast; x++)
+		{
+			json_tape_record_item(aTapes[i], ring_list_getitem(pList, x), aAncestors);
+			aTapes[i].nValues++;
+		}
 	}
-	else if (jsonRoot.get_if<double>())
+
+	std::vector<std::string> aOutputs(nChunks);
+	bool bDone = json_parallel_for(nChunks, nThreads, [&](size_t i) {
+		json_tape_reader oReader(aTapes[i]);
+		for (size_t x = 0; x < aTapes[i].nValues; x++)
+		{
+			if (x > 0)
+			{
+				aOutputs[i] += '\n';
+			}
+			json_write_tape_value(aOutputs[i], oReader);
+		}
+	});
+	if (!bDone)
 	{
-		RING_API_RETSTRING("number");
+		return false;
 	}
-	else if (jsonRoot.get_if<bool>())
+
+	size_t nTotal = nChunks;
+	for (const auto &cOutput : aOutputs)
 	{
-		RING_API_RETSTRING("boolean");
+		nTotal += cOutput.size();
 	}
-	else
+	cOut.reserve(nTotal);
+	for (size_t i = 0; i < nChunks; i++)
 	{
-		RING_API_RETSTRING("null");
+		if (i > 0)
+		{
+			cOut += '\n';
+		}
+		cOut += aOutputs[i];
+		std::string().swap(aOutputs[i]);
 	}
+	return true;
 }
 
-RING_FUNC(ring_json_keys)
+RING_FUNC(ring_json_ndjson_encode)
 {
-	if (RING_API_PARACOUNT != 1)
+	if (RING_API_PARACOUNT < 1 || RING_API_PARACOUNT > 2)
 	{
-		RING_API_ERROR(RING_API_MISS1PARA);
+		RING_API_ERROR(RING_API_BADPARACOUNT);
 		return;
 	}
 
-	if (!RING_API_ISSTRING(1))
+	if (!RING_API_ISLIST(1) || (RING_API_PARACOUNT == 2 && !RING_API_ISNUMBER(2)))
 	{
 		RING_API_ERROR(RING_API_BADPARATYPE);
 		return;
 	}
 
-	const char *cJsonString = RING_API_GETSTRING(1);
-	std::string_view jsonView(cJsonString);
-
-	glz::generic jsonRoot;
-	auto ec = glz::read_json(jsonRoot, jsonView);
-	if (ec)
+	if (RING_API_ISOBJECT(1))
 	{
-		RING_API_ERROR("Invalid JSON input.");
+		RING_API_ERROR("Cannot encode a Ring object to NDJSON.");
 		return;
 	}
 
-	auto *obj = jsonRoot.get_if<glz::generic::object_t>();
-	if (!obj)
+	List *pList = RING_API_GETLIST(1);
+
+	json_output_buffer oOutput;
+	std::string &ndjsonResult = oOutput.str();
+	size_t nThreads = RING_API_PARACOUNT == 2 ? json_thread_count(RING_API_GETNUMBER(2)) : 1;
+	if (nThreads > 1 && ring_list_getsize(pList) >= JSON_PARALLEL_MIN_RECORDS)
 	{
-		RING_API_ERROR("JSON value is not an object.");
+		if (!json_ndjson_encode_parallel(pList, nThreads, ndjsonResult))
+		{
+			RING_API_ERROR("Failed to encode NDJSON.");
+			return;
+		}
+		RING_API_RETSTRING2(ndjsonResult.data(), ndjsonResult.size());
 		return;
 	}
 
-	List *pList = RING_API_NEWLIST;
-	for (const auto &[key, val] : *obj)
+	ring_json_writer oWriter(ndjsonResult, false);
+	for (int i = 1; i <= ring_list_getsize(pList); i++)
 	{
-		ring_list_addstring_gc(RING_API_STATE, pList, key.c_str());
+		if (i > 1)
+		{
+			ndjsonResult += '\n';
+		}
+		oWriter.write_item(ring_list_getitem(pList, i), 0);
 	}
 
-	RING_API_RETLISTBYREF(pList);
+	RING_API_RETSTRING2(ndjsonResult.data(), ndjsonResult.size());
 }
 
-RING_FUNC(ring_json_has)
+RING_FUNC(ring_json_ndjson_decode)
 {
-	if (RING_API_PARACOUNT != 2)
+	if (RING_API_PARACOUNT < 1 || RING_API_PARACOUNT > 2)
 	{
-		RING_API_ERROR(RING_API_MISS2PARA);
+		RING_API_ERROR(RING_API_BADPARACOUNT);
 		return;
 	}
 
-	if (!RING_API_ISSTRING(1) || !RING_API_ISSTRING(2))
+	if (!RING_API_ISSTRING(1) || (RING_API_PARACOUNT == 2 && !RING_API_ISNUMBER(2)))
 	{
 		RING_API_ERROR(RING_API_BADPARATYPE);
 		return;
 	}
 
-	const char *cJsonString = RING_API_GETSTRING(1);
-	const char *cKey = RING_API_GETSTRING(2);
+	std::string_view ndjsonView = JSON_STRING_PARAM(1);
 
-	std::string_view jsonView(cJsonString);
-
-	glz::generic jsonRoot;
-	auto ec = glz::read_json(jsonRoot, jsonView);
-	if (ec)
+	size_t nThreads = RING_API_PARACOUNT == 2 ? json_thread_count(RING_API_GETNUMBER(2)) : 1;
+	if (nThreads > 1 && ndjsonView.size() >= JSON_PARALLEL_MIN_BYTES)
 	{
-		RING_API_RETNUMBER(0.0);
-		return;
+		List *pResultList = RING_API_NEWLIST;
+		if (json_ndjson_to_ring_parallel(RING_API_STATE, ndjsonView, pResultList, nThreads))
+		{
+			RING_API_RETLISTBYREF(pResultList);
+			return;
+		}
+		// Malformed input: the sequential path below reports the error
 	}
 
-	auto *obj = jsonRoot.get_if<glz::generic::object_t>();
-	if (!obj)
+	List *pResultList = RING_API_NEWLIST;
+	if (json_ndjson_to_ring(RING_API_STATE, ndjsonView, pResultList))
 	{
-		RING_API_RETNUMBER(0.0);
+		RING_API_RETLISTBYREF(pResultList);
 		return;
 	}
 
-	RING_API_RETNUMBER(obj->find(cKey) != obj->end() ? 1.0 : 0.0);
-}
+	// Malformed input: rerun through glaze for its error handling
+	ring_list_deleteallitems_gc(RING_API_STATE, pResultList);
 
-RING_FUNC(ring_json_merge)
-{
-	if (RING_API_PARACOUNT != 2)
+	std::vector<glz::generic> items;
+	auto ec = glz::read_ndjson(items, ndjsonView);
+	if (ec)
 	{
-		RING_API_ERROR(RING_API_MISS2PARA);
+		RING_API_ERROR("Failed to decode NDJSON.");
 		return;
 	}
 
-	if (!RING_API_ISSTRING(1) || !RING_API_ISSTRING(2))
+	// Convert to Ring list
+	for (const auto &item : items)
 	{
-		RING_API_ERROR(RING_API_BADPARATYPE);
-		return;
+		List *pTempList = ring_list_newlist_gc(RING_API_STATE, pResultList);
+		json_value_to_ring_item(RING_API_STATE, item, pTempList);
+
+		// Unwrap single-item sublists
+		if (ring_list_getsize(pTempList) == 1)
+		{
+			if (ring_list_islist(pTempList, 1))
+			{
+				List *pInner = ring_list_getlist(pTempList, 1);
+				ring_list_swaptwolists(pTempList, pInner);
+			}
+		}
 	}
 
-	const char *cJson1 = RING_API_GETSTRING(1);
-	const char *cJson2 = RING_API_GETSTRING(2);
+	RING_API_RETLISTBYREF(pResultList);
+}
+
+// ============================================================================
+// NDJSON file iterator (json_ndjson_open handles)
+// ============================================================================
+
+static constexpr const char *JSON_NDJSON_FILE_TYPE = "JSON_NDJSON_FILE";
 
-	glz::generic json1, json2;
+constexpr size_t JSON_NDJSON_READ_SIZE = 1024 * 1024;
+
+// Reads an NDJSON file line by line through one reusable buffer, which only
+// grows when a single line is longer than it
+struct json_ndjson_file
+{
+	FILE *pFile = nullptr;
+	std::string cBuffer;
+	size_t nStart = 0; // first unread byte in cBuffer
+	size_t nEnd = 0;   // end of the valid bytes in cBuffer
+	size_t nLine = 0;  // number of the last line returned
+	bool bEof = false;
 
-	auto ec1 = glz::read_json(json1, std::string_view(cJson1));
-	if (ec1)
+	~json_ndjson_file()
 	{
-		RING_API_ERROR("Invalid JSON in first argument.");
-		return;
+		if (pFile)
+		{
+			fclose(pFile);
+		}
 	}
 
-	auto ec2 = glz::read_json(json2, std::string_view(cJson2));
-	if (ec2)
+	// Sets line to the next non-blank line; false at end of file
+	bool next_line(std::string_view &line)
 	{
-		RING_API_ERROR("Invalid JSON in second argument.");
-		return;
+		for (;;)
+		{
+			const char *pData = cBuffer.data();
+			const char *pNewLine = static_cast<const char *>(memchr(pData + nStart, '\n', nEnd - nStart));
+			if (pNewLine || (bEof && nStart < nEnd))
+			{
+				size_t nLineEnd = pNewLine ? (size_t)(pNewLine - pData) : nEnd;
+				line = std::string_view(pData + nStart, nLineEnd - nStart);
+				nStart = pNewLine ? nLineEnd + 1 : nEnd;
+				nLine++;
+				json_reader oReader(line.data(), line.data() + line.size());
+				oReader.skip_whitespace();
+				if (oReader.pCursor < oReader.pEnd)
+				{
+					return true;
+				}
+				continue;
+			}
+			if (bEof)
+			{
+				return false;
+			}
+			fill();
+		}
 	}
 
-	auto *obj1 = json1.get_if<glz::generic::object_t>();
-	auto *obj2 = json2.get_if<glz::generic::object_t>();
-
-	if (!obj1 || !obj2)
+  private:
+	void fill()
 	{
-		RING_API_ERROR("Both arguments must be JSON objects.");
-		return;
+		// Keep the partial line, moved to the front of the buffer
+		if (nStart > 0)
+		{
+			memmove(&cBuffer[0], cBuffer.data() + nStart, nEnd - nStart);
+			nEnd -= nStart;
+			nStart = 0;
+		}
+		if (cBuffer.size() - nEnd < JSON_NDJSON_READ_SIZE / 2)
+		{
+			cBuffer.resize(std::max(cBuffer.size() * 2, JSON_NDJSON_READ_SIZE));
+		}
+		size_t nRead = fread(&cBuffer[nEnd], 1, cBuffer.size() - nEnd, pFile);
+		nEnd += nRead;
+		if (nRead == 0)
+		{
+			bEof = true;
+		}
 	}
+};
+
+static void json_ndjson_file_free(void *, void *pPointer)
+{
+	delete static_cast<json_ndjson_file *>(pPointer);
+}
 
-	for (const auto &[key, val] : *obj2)
+// Decodes the next record of oFile into pList, or into a new sub-list of it
+// when bSubList is set. Returns false at end of file or, with an error
+// raised, on a malformed record.
+static bool json_ndjson_file_read(void *pPointer, json_ndjson_file &oFile, List *pList, bool bSubList,
+								  bool &bFailed)
+{
+	std::string_view line;
+	if (!oFile.next_line(line))
 	{
-		(*obj1)[key] = val;
+		return false;
 	}
-
-	std::string result;
-	auto ec = glz::write_json(json1, result);
-	if (ec)
+	List *pRecord = bSubList ? ring_list_newlist_gc(RING_API_STATE, pList) : pList;
+	json_reader oReader(line.data(), line.data() + line.size());
+	if (!json_read_ring_item(RING_API_STATE, oReader, pRecord, true) || !oReader.finish())
 	{
-		RING_API_ERROR("Failed to serialize merged JSON.");
-		return;
+		std::string cError = "Failed to decode NDJSON record at line " + std::to_string(oFile.nLine) + ".";
+		RING_API_ERROR(cError.c_str());
+		bFailed = true;
+		return false;
 	}
-
-	RING_API_RETSTRING(result.c_str());
+	return true;
 }
 
-RING_FUNC(ring_json_read_file)
+RING_FUNC(ring_json_ndjson_open)
 {
 	if (RING_API_PARACOUNT != 1)
 	{
@@ -745,111 +5068,72 @@ RING_FUNC(ring_json_read_file)
 		return;
 	}
 
-	const char *cFilePath = RING_API_GETSTRING(1);
-
-	std::ifstream file(cFilePath);
-	if (!file.is_open())
+	FILE *pFile = fopen(RING_API_GETSTRING(1), "rb");
+	if (!pFile)
 	{
 		RING_API_ERROR("Cannot open file for reading.");
 		return;
 	}
 
-	std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-	file.close();
-
-	glz::generic jsonRoot;
-	auto ec = glz::read_json(jsonRoot, content);
-	if (ec)
-	{
-		std::string errorMsg = "JSON error: " + std::string(glz::format_error(ec, content));
-		RING_API_ERROR(errorMsg.c_str());
-		return;
-	}
-
-	List *pTempList = RING_API_NEWLIST;
-	json_value_to_ring_item(RING_API_STATE, jsonRoot, pTempList);
-
-	if (ring_list_getsize(pTempList) == 1 && ring_list_islist(pTempList, 1))
-	{
-		List *pResultList = ring_list_getlist(pTempList, 1);
-		List *pFinalList = RING_API_NEWLIST;
-		ring_list_swaptwolists(pFinalList, pResultList);
-		RING_API_RETLISTBYREF(pFinalList);
-	}
-	else
-	{
-		RING_API_RETLISTBYREF(pTempList);
-	}
+	auto *pNdjson = new json_ndjson_file();
+	pNdjson->pFile = pFile;
+	RING_API_RETMANAGEDCPOINTER(pNdjson, JSON_NDJSON_FILE_TYPE, json_ndjson_file_free);
 }
 
-RING_FUNC(ring_json_write_file)
+RING_FUNC(ring_json_ndjson_next)
 {
-	if (RING_API_PARACOUNT < 2 || RING_API_PARACOUNT > 3)
+	if (RING_API_PARACOUNT < 1 || RING_API_PARACOUNT > 2)
 	{
 		RING_API_ERROR(RING_API_BADPARACOUNT);
 		return;
 	}
 
-	if (!RING_API_ISLIST(1) || !RING_API_ISSTRING(2))
+	if (!RING_API_ISCPOINTER(1) || (RING_API_PARACOUNT == 2 && !RING_API_ISNUMBER(2)))
 	{
 		RING_API_ERROR(RING_API_BADPARATYPE);
 		return;
 	}
 
-	if (RING_API_ISOBJECT(1))
+	auto *pNdjson = static_cast<json_ndjson_file *>(RING_API_GETCPOINTER(1, JSON_NDJSON_FILE_TYPE));
+	if (!pNdjson)
 	{
-		RING_API_ERROR("Cannot encode a Ring object directly to JSON.");
+		RING_API_ERROR("Invalid or closed NDJSON file handle.");
 		return;
 	}
 
-	bool prettyPrint = false;
-	if (RING_API_PARACOUNT == 3 && RING_API_ISNUMBER(3))
-	{
-		prettyPrint = (RING_API_GETNUMBER(3) == 1.0);
-	}
-
-	List *pList = RING_API_GETLIST(1);
-	const char *cFilePath = RING_API_GETSTRING(2);
-	VM *pVM = static_cast<VM *>(pPointer);
-
-	List *pVisited = ring_list_new_gc(pVM->pRingState, 0);
-	glz::generic jsonRoot = ring_list_to_json_value(pVM, pList, pVisited);
-	ring_list_delete_gc(pVM->pRingState, pVisited);
+	bool bFailed = false;
+	List *pList = RING_API_NEWLIST;
 
-	std::string jsonString;
-	if (prettyPrint)
+	if (RING_API_PARACOUNT == 1)
 	{
-		auto ec = glz::write<glz::opts{.prettify = true}>(jsonRoot, jsonString);
-		if (ec)
+		// A single record, or an empty string once the file is exhausted
+		if (json_ndjson_file_read(pPointer, *pNdjson, pList, false, bFailed))
 		{
-			RING_API_ERROR("Failed to generate JSON string.");
-			return;
+			RING_API_RETLISTBYREF(pList);
+		}
+		else if (!bFailed)
+		{
+			RING_API_RETSTRING("");
 		}
+		return;
 	}
-	else
+
+	// A batch of up to nCount records; empty once the file is exhausted
+	double nCount = RING_API_GETNUMBER(2);
+	for (double x = 0; x < nCount; x++)
 	{
-		auto ec = glz::write_json(jsonRoot, jsonString);
-		if (ec)
+		if (!json_ndjson_file_read(pPointer, *pNdjson, pList, true, bFailed))
 		{
-			RING_API_ERROR("Failed to generate JSON string.");
-			return;
+			break;
 		}
 	}
-
-	std::ofstream file(cFilePath);
-	if (!file.is_open())
+	if (!bFailed)
 	{
-		RING_API_ERROR("Cannot open file for writing.");
-		return;
+		RING_API_RETLISTBYREF(pList);
 	}
-
-	file << jsonString;
-	file.close();
-
-	RING_API_RETNUMBER(1.0);
 }
 
-RING_FUNC(ring_json_to_beve)
+RING_FUNC(ring_json_ndjson_close)
 {
 	if (RING_API_PARACOUNT != 1)
 	{
@@ -857,510 +5141,995 @@ RING_FUNC(ring_json_to_beve)
 		return;
 	}
 
-	if (!RING_API_ISSTRING(1))
+	if (!RING_API_ISCPOINTER(1))
 	{
 		RING_API_ERROR(RING_API_BADPARATYPE);
 		return;
 	}
 
-	const char *cJsonString = RING_API_GETSTRING(1);
-	std::string_view jsonView(cJsonString);
-
-	glz::generic jsonRoot;
-	auto ec = glz::read_json(jsonRoot, jsonView);
-	if (ec)
+	auto *pNdjson = static_cast<json_ndjson_file *>(RING_API_GETCPOINTER(1, JSON_NDJSON_FILE_TYPE));
+	if (pNdjson)
 	{
-		RING_API_ERROR("Invalid JSON input.");
-		return;
+		delete pNdjson;
+		RING_API_SETNULLPOINTER(1);
 	}
+}
 
-	std::string beveData;
-	auto ec2 = glz::write_beve(jsonRoot, beveData);
-	if (ec2)
+// ============================================================================
+// Utility Functions
+// ============================================================================
+
+// Helper: Compare the text of two string/key tokens after unescaping
+static bool json_token_text_equal(const json_reader &oLeft, const json_reader &oRight, std::string &cLeftScratch,
+								  std::string &cRightScratch)
+{
+	std::string_view cLeft = oLeft.text();
+	std::string_view cRight = oRight.text();
+	if (oLeft.bEscaped)
 	{
-		RING_API_ERROR("Failed to convert to BEVE.");
-		return;
+		json_unescape(cLeft, cLeftScratch);
+		cLeft = cLeftScratch;
 	}
-
-	RING_API_RETSTRING2(beveData.c_str(), beveData.size());
+	if (oRight.bEscaped)
+	{
+		json_unescape(cRight, cRightScratch);
+		cRight = cRightScratch;
+	}
+	return cLeft == cRight;
 }
 
-RING_FUNC(ring_beve_to_json)
+static bool json_equal_text(std::string_view cLeft, std::string_view cRight);
+
+// Helper: Collect the remaining members of the object whose KEY token was just
+// read, as key -> raw value text; a repeated key keeps its last value. Values
+// are skipped, not decoded.
+static bool json_collect_members(json_reader &oReader, std::string &cScratch,
+								 std::unordered_map<std::string, std::string_view> &aMembers)
 {
-	if (RING_API_PARACOUNT != 1)
+	for (;;)
 	{
-		RING_API_ERROR(RING_API_MISS1PARA);
-		return;
+		std::string_view cKey = oReader.text();
+		if (oReader.bEscaped)
+		{
+			json_unescape(cKey, cScratch);
+			cKey = cScratch;
+		}
+		const char *pValue = oReader.pCursor;
+		if (!oReader.skip_value())
+		{
+			return false;
+		}
+		aMembers[std::string(cKey)] = std::string_view(pValue, oReader.pCursor - pValue);
+
+		json_token nToken = oReader.next();
+		if (nToken == JSON_TOKEN_OBJECT_END)
+		{
+			return true;
+		}
+		if (nToken != JSON_TOKEN_KEY)
+		{
+			return false;
+		}
 	}
+}
 
-	if (!RING_API_ISSTRING(1))
+// Helper: Compare two sets of collected members by key, in both directions
+static bool json_equal_member_maps(const std::unordered_map<std::string, std::string_view> &aLeft,
+								   const std::unordered_map<std::string, std::string_view> &aRight)
+{
+	for (const auto &[cKey, cValue] : aLeft)
 	{
-		RING_API_ERROR(RING_API_BADPARATYPE);
-		return;
+		auto it = aRight.find(cKey);
+		if (it == aRight.end() || !json_equal_text(cValue, it->second))
+		{
+			return false;
+		}
 	}
-
-	const char *cBeveData = RING_API_GETSTRING(1);
-	int nSize = RING_API_GETSTRINGSIZE(1);
-
-	glz::generic jsonRoot;
-	auto ec = glz::read_beve(jsonRoot, std::string_view(cBeveData, nSize));
-	if (ec)
+	for (const auto &[cKey, cValue] : aRight)
 	{
-		RING_API_ERROR("Invalid BEVE input.");
-		return;
+		if (aLeft.find(cKey) == aLeft.end())
+		{
+			return false;
+		}
 	}
+	return true;
+}
 
-	std::string jsonString;
-	auto ec2 = glz::write_json(jsonRoot, jsonString);
-	if (ec2)
+// Helper: Whether any object in the JSON text repeats a key
+static bool json_has_repeated_keys(std::string_view json)
+{
+	json_reader oReader(json.data(), json.data() + json.size());
+	std::vector<std::unordered_set<std::string>> aLevels; // keys of each open object, reused
+	size_t nLevels = 0;
+	std::string cScratch;
+	for (;;)
 	{
-		RING_API_ERROR("Failed to convert to JSON.");
-		return;
+		switch (oReader.next())
+		{
+		case JSON_TOKEN_OBJECT_BEGIN:
+			if (nLevels == aLevels.size())
+			{
+				aLevels.emplace_back();
+			}
+			aLevels[nLevels++].clear();
+			break;
+		case JSON_TOKEN_OBJECT_END:
+			nLevels--;
+			break;
+		case JSON_TOKEN_KEY:
+			if (!aLevels[nLevels - 1].emplace(json_token_text(oReader, cScratch)).second)
+			{
+				return true;
+			}
+			break;
+		case JSON_TOKEN_ERROR:
+		case JSON_TOKEN_EOF:
+			return false;
+		default:
+			break;
+		}
 	}
-
-	RING_API_RETSTRING(jsonString.c_str());
 }
 
-// ============================================================================
-// JSON Patch (RFC 6902)
-// ============================================================================
-
-RING_FUNC(ring_json_patch)
+// Helper: Span of the next element of the array oReader is in (without the
+// separating comma), and its first token: JSON_TOKEN_ARRAY_END past the last
+// element, JSON_TOKEN_ERROR on malformed input
+static json_token json_next_element(json_reader &oReader, std::string_view &cElement)
 {
-	if (RING_API_PARACOUNT != 2)
+	const char *pBegin = oReader.pCursor;
+	json_token nToken = oReader.next();
+	if ((nToken == JSON_TOKEN_OBJECT_BEGIN || nToken == JSON_TOKEN_ARRAY_BEGIN) && !oReader.skip_container())
 	{
-		RING_API_ERROR(RING_API_MISS2PARA);
-		return;
+		return JSON_TOKEN_ERROR;
+	}
+	while (pBegin < oReader.pCursor && (json_is_whitespace(*pBegin) || *pBegin == ','))
+	{
+		pBegin++;
 	}
+	cElement = std::string_view(pBegin, oReader.pCursor - pBegin);
+	return nToken;
+}
 
-	if (!RING_API_ISSTRING(1) || !RING_API_ISSTRING(2))
+// Helper: Compare two JSON texts level by level: object members are collected
+// by key, a repeated key keeping its last value as in json_parse() trees, and
+// array elements pairwise. Slower than the lockstep walk, which cannot tell
+// whether a difference is undone by a later repeated key.
+static bool json_equal_members(std::string_view cLeft, std::string_view cRight)
+{
+	json_reader oLeft(cLeft.data(), cLeft.data() + cLeft.size());
+	json_reader oRight(cRight.data(), cRight.data() + cRight.size());
+	std::string cLeftScratch, cRightScratch;
+
+	json_token nToken = oLeft.next();
+	if (oRight.next() != nToken)
 	{
-		RING_API_ERROR(RING_API_BADPARATYPE);
-		return;
+		return false;
+	}
+	if (nToken == JSON_TOKEN_OBJECT_BEGIN)
+	{
+		auto fnCollect = [](json_reader &oReader, std::string &cScratch,
+							std::unordered_map<std::string, std::string_view> &aMembers) {
+			json_token nFirst = oReader.next();
+			return nFirst == JSON_TOKEN_OBJECT_END ||
+				   (nFirst == JSON_TOKEN_KEY && json_collect_members(oReader, cScratch, aMembers));
+		};
+		std::unordered_map<std::string, std::string_view> aLeftMembers, aRightMembers;
+		if (!fnCollect(oLeft, cLeftScratch, aLeftMembers) || !fnCollect(oRight, cRightScratch, aRightMembers) ||
+			!json_equal_member_maps(aLeftMembers, aRightMembers))
+		{
+			return false;
+		}
+	}
+	else if (nToken == JSON_TOKEN_ARRAY_BEGIN)
+	{
+		for (;;)
+		{
+			std::string_view cLeftElement, cRightElement;
+			json_token nLeftToken = json_next_element(oLeft, cLeftElement);
+			json_token nRightToken = json_next_element(oRight, cRightElement);
+			if (nLeftToken == JSON_TOKEN_ERROR || nRightToken == JSON_TOKEN_ERROR)
+			{
+				return false;
+			}
+			if (nLeftToken == JSON_TOKEN_ARRAY_END || nRightToken == JSON_TOKEN_ARRAY_END)
+			{
+				if (nLeftToken != nRightToken)
+				{
+					return false;
+				}
+				break;
+			}
+			if (!json_equal_text(cLeftElement, cRightElement))
+			{
+				return false;
+			}
+		}
 	}
-
-	const char *cDocJson = RING_API_GETSTRING(1);
-	const char *cPatchJson = RING_API_GETSTRING(2);
-
-	auto result = glz::patch_json(std::string_view(cDocJson), std::string_view(cPatchJson));
-	if (!result)
+	else
 	{
-		RING_API_ERROR("Failed to apply JSON patch.");
-		return;
+		// Scalars have no keys to repeat; the lockstep walk already decided
+		return false;
 	}
-
-	RING_API_RETSTRING(result->c_str());
+	return oLeft.finish() && oRight.finish();
 }
 
-RING_FUNC(ring_json_diff)
+// Helper: Compare two JSON texts by walking both token streams in lockstep,
+// stopping at the first difference. Where an object lists its members in a
+// different order, only the rest of that object is buffered (as raw value
+// spans) and its members are compared by key. Invalid JSON is never equal.
+static bool json_equal_lockstep(std::string_view cLeft, std::string_view cRight)
 {
-	if (RING_API_PARACOUNT != 2)
-	{
-		RING_API_ERROR(RING_API_MISS2PARA);
-		return;
-	}
+	json_reader oLeft(cLeft.data(), cLeft.data() + cLeft.size());
+	json_reader oRight(cRight.data(), cRight.data() + cRight.size());
+	std::string cLeftScratch, cRightScratch;
 
-	if (!RING_API_ISSTRING(1) || !RING_API_ISSTRING(2))
+	for (;;)
 	{
-		RING_API_ERROR(RING_API_BADPARATYPE);
-		return;
+		json_token nToken = oLeft.next();
+		if (oRight.next() != nToken)
+		{
+			return false;
+		}
+		switch (nToken)
+		{
+		case JSON_TOKEN_ERROR:
+			return false;
+		case JSON_TOKEN_EOF:
+			return oLeft.finish() && oRight.finish();
+		case JSON_TOKEN_STRING:
+			if (!json_token_text_equal(oLeft, oRight, cLeftScratch, cRightScratch))
+			{
+				return false;
+			}
+			break;
+		case JSON_TOKEN_NUMBER:
+			if (oLeft.text() != oRight.text() && oLeft.number() != oRight.number())
+			{
+				return false;
+			}
+			break;
+		case JSON_TOKEN_KEY:
+			if (!json_token_text_equal(oLeft, oRight, cLeftScratch, cRightScratch))
+			{
+				std::unordered_map<std::string, std::string_view> aLeftMembers, aRightMembers;
+				if (!json_collect_members(oLeft, cLeftScratch, aLeftMembers) ||
+					!json_collect_members(oRight, cRightScratch, aRightMembers) ||
+					!json_equal_member_maps(aLeftMembers, aRightMembers))
+				{
+					return false;
+				}
+			}
+			break;
+		default:
+			break;
+		}
 	}
+}
 
-	const char *cSourceJson = RING_API_GETSTRING(1);
-	const char *cTargetJson = RING_API_GETSTRING(2);
-
-	auto patch = glz::diff(std::string_view(cSourceJson), std::string_view(cTargetJson));
-	if (!patch)
+// Helper: Compare two JSON texts as json_equal() does. A repeated object key
+// keeps its last value, so when the lockstep walk finds a difference and
+// either text repeats a key, the texts are compared again member by member.
+static bool json_equal_text(std::string_view cLeft, std::string_view cRight)
+{
+	if (json_equal_lockstep(cLeft, cRight))
 	{
-		RING_API_ERROR("Failed to generate JSON diff.");
-		return;
+		return true;
 	}
-
-	std::string patchJson;
-	auto ec = glz::write_json(*patch, patchJson);
-	if (ec)
+	if (!json_has_repeated_keys(cLeft) && !json_has_repeated_keys(cRight))
 	{
-		RING_API_ERROR("Failed to serialize JSON patch.");
-		return;
+		return false;
 	}
-
-	RING_API_RETSTRING(patchJson.c_str());
+	return json_equal_members(cLeft, cRight);
 }
 
-// ============================================================================
-// JSON Merge Patch (RFC 7386)
-// ============================================================================
-
-RING_FUNC(ring_json_merge_patch)
+// Helper: Count elements in a document tree value
+static size_t json_tree_size(const json_value &value)
 {
-	if (RING_API_PARACOUNT != 2)
+	if (auto *obj = value.get_if<json_value::object_t>())
 	{
-		RING_API_ERROR(RING_API_MISS2PARA);
-		return;
+		return obj->size();
 	}
-
-	if (!RING_API_ISSTRING(1) || !RING_API_ISSTRING(2))
+	else if (auto *arr = value.get_if<json_value::array_t>())
 	{
-		RING_API_ERROR(RING_API_BADPARATYPE);
-		return;
+		return arr->size();
 	}
+	return 1; // Scalar values count as 1
+}
 
-	const char *cTargetJson = RING_API_GETSTRING(1);
-	const char *cPatchJson = RING_API_GETSTRING(2);
-
-	auto result = glz::merge_patch_json(std::string_view(cTargetJson), std::string_view(cPatchJson));
-	if (!result)
+// Helper: Calculate max depth of a document tree value without recursion,
+// stopping as soon as it exceeds nLimit
+static size_t json_tree_depth(const json_value &value, size_t nLimit = SIZE_MAX)
+{
+	std::vector<std::pair<const json_value *, size_t>> aPending{{&value, 0}};
+	size_t nMaxDepth = 0;
+	while (!aPending.empty())
 	{
-		RING_API_ERROR("Failed to apply merge patch.");
-		return;
+		auto [pValue, nDepth] = aPending.back();
+		aPending.pop_back();
+		if (auto *obj = pValue->get_if<json_value::object_t>())
+		{
+			nMaxDepth = std::max(nMaxDepth, nDepth + 1);
+			for (const auto &[key, val] : *obj)
+			{
+				aPending.emplace_back(&val, nDepth + 1);
+			}
+		}
+		else if (auto *arr = pValue->get_if<json_value::array_t>())
+		{
+			nMaxDepth = std::max(nMaxDepth, nDepth + 1);
+			for (const auto &val : *arr)
+			{
+				aPending.emplace_back(&val, nDepth + 1);
+			}
+		}
+		if (nMaxDepth > nLimit)
+		{
+			break;
+		}
 	}
-
-	RING_API_RETSTRING(result->c_str());
+	return nMaxDepth;
 }
 
-RING_FUNC(ring_json_merge_diff)
+enum json_measure
 {
-	if (RING_API_PARACOUNT != 2)
+	JSON_MEASURE_SIZE,
+	JSON_MEASURE_DEPTH
+};
+
+// Measures a JSON text in one pass over its tokens: the number of root members
+// (1 for a scalar) or the maximum nesting depth. Stops as soon as the result
+// exceeds nLimit, leaving the rest of the text unread. Returns false on
+// invalid JSON.
+static bool json_measure_text(std::string_view json, json_measure nMeasure, size_t nLimit, size_t &nResult)
+{
+	json_reader oReader(json.data(), json.data() + json.size());
+	json_token nToken = oReader.next();
+	if (nToken == JSON_TOKEN_ERROR || nToken == JSON_TOKEN_EOF)
 	{
-		RING_API_ERROR(RING_API_MISS2PARA);
-		return;
+		return false;
 	}
-
-	if (!RING_API_ISSTRING(1) || !RING_API_ISSTRING(2))
+	if (nToken != JSON_TOKEN_OBJECT_BEGIN && nToken != JSON_TOKEN_ARRAY_BEGIN)
 	{
-		RING_API_ERROR(RING_API_BADPARATYPE);
-		return;
+		nResult = nMeasure == JSON_MEASURE_SIZE ? 1 : 0;
+		return oReader.finish();
 	}
 
-	const char *cSourceJson = RING_API_GETSTRING(1);
-	const char *cTargetJson = RING_API_GETSTRING(2);
-
-	auto patch = glz::merge_diff_json(std::string_view(cSourceJson), std::string_view(cTargetJson));
-	if (!patch)
+	bool bRootArray = nToken == JSON_TOKEN_ARRAY_BEGIN;
+	nResult = nMeasure == JSON_MEASURE_SIZE ? 0 : 1;
+	while (oReader.nDepth > 0 && nResult <= nLimit)
 	{
-		RING_API_ERROR("Failed to generate merge diff.");
-		return;
+		nToken = oReader.next();
+		switch (nToken)
+		{
+		case JSON_TOKEN_ERROR:
+		case JSON_TOKEN_EOF:
+			return false;
+		case JSON_TOKEN_OBJECT_BEGIN:
+		case JSON_TOKEN_ARRAY_BEGIN:
+			if (nMeasure == JSON_MEASURE_DEPTH)
+			{
+				nResult = std::max(nResult, oReader.nDepth);
+			}
+			else if (bRootArray && oReader.nDepth == 2)
+			{
+				nResult++;
+			}
+			break;
+		case JSON_TOKEN_OBJECT_END:
+		case JSON_TOKEN_ARRAY_END:
+			break;
+		case JSON_TOKEN_KEY:
+			if (nMeasure == JSON_MEASURE_SIZE && !bRootArray && oReader.nDepth == 1)
+			{
+				nResult++;
+			}
+			break;
+		default:
+			if (nMeasure == JSON_MEASURE_SIZE && bRootArray && oReader.nDepth == 1)
+			{
+				nResult++;
+			}
+			break;
+		}
 	}
-
-	RING_API_RETSTRING(patch->c_str());
+	return nResult > nLimit || oReader.finish();
 }
 
-// ============================================================================
-// CBOR (Concise Binary Object Representation)
-// ============================================================================
-
-RING_FUNC(ring_json_to_cbor)
+// Shared body of json_size() and json_depth(): (json [, limit])
+static void json_measure_param(void *pPointer, json_measure nMeasure)
 {
-	if (RING_API_PARACOUNT != 1)
+	if (RING_API_PARACOUNT < 1 || RING_API_PARACOUNT > 2)
 	{
-		RING_API_ERROR(RING_API_MISS1PARA);
+		RING_API_ERROR(RING_API_BADPARACOUNT);
 		return;
 	}
 
-	if (!RING_API_ISSTRING(1))
+	if ((!RING_API_ISSTRING(1) && !RING_API_ISCPOINTER(1)) ||
+		(RING_API_PARACOUNT == 2 && (!RING_API_ISNUMBER(2) || RING_API_GETNUMBER(2) < 0)))
 	{
 		RING_API_ERROR(RING_API_BADPARATYPE);
 		return;
 	}
 
-	const char *cJsonString = RING_API_GETSTRING(1);
-	std::string_view jsonView(cJsonString);
+	size_t nLimit = RING_API_PARACOUNT == 2 ? json_size_from_number(RING_API_GETNUMBER(2)) : SIZE_MAX;
+	size_t nResult;
 
-	glz::generic jsonRoot;
-	auto ec = glz::read_json(jsonRoot, jsonView);
-	if (ec)
+	if (RING_API_ISSTRING(1))
 	{
-		RING_API_ERROR("Invalid JSON input.");
-		return;
+		if (!json_measure_text(JSON_STRING_PARAM(1), nMeasure, nLimit, nResult))
+		{
+			RING_API_ERROR("Invalid JSON input.");
+			return;
+		}
 	}
-
-	std::string cborData;
-	auto ec2 = glz::write_cbor(jsonRoot, cborData);
-	if (ec2)
+	else
 	{
-		RING_API_ERROR("Failed to convert to CBOR.");
-		return;
+		const json_value *pRoot = json_document_param(pPointer, 1);
+		if (!pRoot)
+		{
+			return;
+		}
+		if (nMeasure == JSON_MEASURE_SIZE)
+		{
+			nResult = std::min(json_tree_size(*pRoot), nLimit == SIZE_MAX ? nLimit : nLimit + 1);
+		}
+		else
+		{
+			nResult = json_tree_depth(*pRoot, nLimit);
+		}
 	}
 
-	RING_API_RETSTRING2(cborData.c_str(), cborData.size());
+	RING_API_RETNUMBER(static_cast<double>(nResult));
 }
 
-RING_FUNC(ring_cbor_to_json)
+// Helper: Sort the keys of every object in a document tree, in place
+static void json_tree_sort_keys(json_value &value)
 {
-	if (RING_API_PARACOUNT != 1)
+	if (auto *obj = value.get_if<json_value::object_t>())
 	{
-		RING_API_ERROR(RING_API_MISS1PARA);
-		return;
+		obj->sort_keys();
+		for (auto &[key, val] : *obj)
+		{
+			json_tree_sort_keys(val);
+		}
 	}
-
-	if (!RING_API_ISSTRING(1))
+	else if (auto *arr = value.get_if<json_value::array_t>())
 	{
-		RING_API_ERROR(RING_API_BADPARATYPE);
-		return;
+		for (auto &val : *arr)
+		{
+			json_tree_sort_keys(val);
+		}
 	}
+}
 
-	const char *cCborData = RING_API_GETSTRING(1);
-	int nSize = RING_API_GETSTRINGSIZE(1);
-
-	glz::generic jsonRoot;
-	auto ec = glz::read_cbor(jsonRoot, std::string_view(cCborData, nSize));
-	if (ec)
+// Helper: Structural 64-bit hash fed one token at a time. Object members are
+// summed, so member order does not matter, and a repeated key replaces the
+// earlier member's term (the last value wins); array elements are chained in
+// order. Numbers hash by value and strings by their unescaped bytes, so
+// documents that json_equal() considers equal hash the same.
+class json_structural_hash
+{
+  public:
+	void begin(bool bObject)
 	{
-		RING_API_ERROR("Invalid CBOR input.");
-		return;
+		if (nFrames == aFrames.size())
+		{
+			aFrames.emplace_back();
+		}
+		frame &oFrame = aFrames[nFrames++];
+		oFrame.bObject = bObject;
+		oFrame.nState = bObject ? 0 : seed(JSON_TOKEN_ARRAY_BEGIN);
+		oFrame.nKey = 0;
+		oFrame.nCount = 0;
+		oFrame.aMembers.clear();
 	}
 
-	std::string jsonString;
-	auto ec2 = glz::write_json(jsonRoot, jsonString);
-	if (ec2)
+	void key(std::string_view cKey)
 	{
-		RING_API_ERROR("Failed to convert to JSON.");
-		return;
+		aFrames[nFrames - 1].nKey = bytes(cKey, seed(JSON_TOKEN_KEY));
 	}
 
-	RING_API_RETSTRING(jsonString.c_str());
-}
-
-// ============================================================================
-// NDJSON (Newline Delimited JSON / JSON Lines)
-// ============================================================================
-
-RING_FUNC(ring_json_ndjson_encode)
-{
-	if (RING_API_PARACOUNT != 1)
+	void end()
 	{
-		RING_API_ERROR(RING_API_MISS1PARA);
-		return;
+		const frame &oFrame = aFrames[--nFrames];
+		uint64_t nHash = oFrame.bObject ? mix(seed(JSON_TOKEN_OBJECT_BEGIN) ^ mix(oFrame.nState + oFrame.nCount))
+										: mix(oFrame.nState ^ oFrame.nCount);
+		value(nHash);
 	}
 
-	if (!RING_API_ISLIST(1))
+	void string(std::string_view cText)
 	{
-		RING_API_ERROR(RING_API_BADPARATYPE);
-		return;
+		value(bytes(cText, seed(JSON_TOKEN_STRING)));
 	}
 
-	if (RING_API_ISOBJECT(1))
+	void number(double nNumber)
 	{
-		RING_API_ERROR("Cannot encode a Ring object to NDJSON.");
-		return;
+		// -0 and 0 are the same JSON number
+		value(mix(seed(JSON_TOKEN_NUMBER) ^ std::bit_cast<uint64_t>(nNumber == 0 ? 0.0 : nNumber)));
 	}
 
-	List *pList = RING_API_GETLIST(1);
-	VM *pVM = static_cast<VM *>(pPointer);
-
-	// Build array of generic values
-	std::vector<glz::generic> items;
-	items.reserve(ring_list_getsize(pList));
-
-	List *pVisited = ring_list_new_gc(pVM->pRingState, 0);
-
-	for (int i = 1; i <= ring_list_getsize(pList); i++)
+	void literal(json_token nToken)
 	{
-		Item *pItem = ring_list_getitem(pList, i);
-		items.push_back(ring_item_to_json_value(pVM, pItem, pVisited));
-		// Clear visited for next item
-		ring_list_deleteallitems_gc(pVM->pRingState, pVisited);
+		value(seed(nToken));
 	}
 
-	ring_list_delete_gc(pVM->pRingState, pVisited);
-
-	// Write as NDJSON
-	std::string ndjsonResult;
-	auto ec = glz::write_ndjson(items, ndjsonResult);
-	if (ec)
+	// True once a complete root value has been hashed
+	bool done() const
 	{
-		RING_API_ERROR("Failed to encode NDJSON.");
-		return;
+		return bDone;
 	}
 
-	RING_API_RETSTRING(ndjsonResult.c_str());
-}
-
-RING_FUNC(ring_json_ndjson_decode)
-{
-	if (RING_API_PARACOUNT != 1)
+	uint64_t result() const
 	{
-		RING_API_ERROR(RING_API_MISS1PARA);
-		return;
+		return nResult;
 	}
 
-	if (!RING_API_ISSTRING(1))
+  private:
+	struct frame
 	{
-		RING_API_ERROR(RING_API_BADPARATYPE);
-		return;
-	}
+		bool bObject;
+		uint64_t nState;
+		uint64_t nKey;
+		uint64_t nCount;
+		std::unordered_map<uint64_t, uint64_t> aMembers; // key hash -> member term
+	};
 
-	const char *cNdjsonString = RING_API_GETSTRING(1);
-	std::string ndjsonInput(cNdjsonString);
+	std::vector<frame> aFrames; // open containers; entries past nFrames are kept for reuse
+	size_t nFrames = 0;
+	uint64_t nResult = 0;
+	bool bDone = false;
 
-	std::vector<glz::generic> items;
-	auto ec = glz::read_ndjson(items, ndjsonInput);
-	if (ec)
+	static uint64_t mix(uint64_t n)
 	{
-		RING_API_ERROR("Failed to decode NDJSON.");
-		return;
+		n ^= n >> 30;
+		n *= 0xBF58476D1CE4E5B9ULL;
+		n ^= n >> 27;
+		n *= 0x94D049BB133111EBULL;
+		return n ^ (n >> 31);
 	}
 
-	// Convert to Ring list
-	List *pResultList = RING_API_NEWLIST;
-	for (const auto &item : items)
+	static uint64_t seed(json_token nToken)
 	{
-		List *pTempList = ring_list_newlist_gc(RING_API_STATE, pResultList);
-		json_value_to_ring_item(RING_API_STATE, item, pTempList);
+		return mix(0x9E3779B97F4A7C15ULL * (static_cast<uint64_t>(nToken) + 1));
+	}
 
-		// Unwrap single-item sublists
-		if (ring_list_getsize(pTempList) == 1)
+	// Reads bytes little-endian so the hash is the same on every platform
+	static uint64_t bytes(std::string_view cText, uint64_t nHash)
+	{
+		const unsigned char *p = reinterpret_cast<const unsigned char *>(cText.data());
+		size_t nSize = cText.size();
+		nHash ^= mix(nSize);
+		while (nSize > 0)
 		{
-			if (ring_list_islist(pTempList, 1))
+			size_t nChunk = nSize < 8 ? nSize : 8;
+			uint64_t nWord = 0;
+			for (size_t i = 0; i < nChunk; i++)
 			{
-				List *pInner = ring_list_getlist(pTempList, 1);
-				ring_list_swaptwolists(pTempList, pInner);
+				nWord |= static_cast<uint64_t>(p[i]) << (8 * i);
 			}
+			nHash = mix(nHash ^ nWord);
+			p += nChunk;
+			nSize -= nChunk;
 		}
+		return nHash;
 	}
 
-	RING_API_RETLISTBYREF(pResultList);
-}
+	void value(uint64_t nHash)
+	{
+		if (nFrames == 0)
+		{
+			nResult = nHash;
+			bDone = true;
+			return;
+		}
+		frame &oFrame = aFrames[nFrames - 1];
+		if (oFrame.bObject)
+		{
+			uint64_t nTerm = mix(oFrame.nKey ^ std::rotl(nHash, 17));
+			auto [it, bNew] = oFrame.aMembers.try_emplace(oFrame.nKey, nTerm);
+			if (!bNew)
+			{
+				oFrame.nState -= it->second;
+				it->second = nTerm;
+			}
+			oFrame.nState += nTerm;
+			oFrame.nCount += bNew ? 1 : 0;
+		}
+		else
+		{
+			oFrame.nState = mix(oFrame.nState ^ nHash);
+			oFrame.nCount++;
+		}
+	}
+};
 
-// ============================================================================
-// Utility Functions
-// ============================================================================
+// Helper: Hash the next complete value of oReader (a json_reader or a
+// json_tape_reader)
+template <class Reader> static bool json_hash_tokens(Reader &oReader, json_structural_hash &oHash)
+{
+	std::string cScratch;
+	do
+	{
+		json_token nToken = oReader.next();
+		switch (nToken)
+		{
+		case JSON_TOKEN_OBJECT_BEGIN:
+		case JSON_TOKEN_ARRAY_BEGIN:
+			oHash.begin(nToken == JSON_TOKEN_OBJECT_BEGIN);
+			break;
+		case JSON_TOKEN_OBJECT_END:
+		case JSON_TOKEN_ARRAY_END:
+			oHash.end();
+			break;
+		case JSON_TOKEN_KEY:
+		case JSON_TOKEN_STRING: {
+			std::string_view cText = oReader.text();
+			if (oReader.bEscaped)
+			{
+				json_unescape(cText, cScratch);
+				cText = cScratch;
+			}
+			if (nToken == JSON_TOKEN_KEY)
+			{
+				oHash.key(cText);
+			}
+			else
+			{
+				oHash.string(cText);
+			}
+			break;
+		}
+		case JSON_TOKEN_NUMBER:
+			oHash.number(oReader.number());
+			break;
+		case JSON_TOKEN_TRUE:
+		case JSON_TOKEN_FALSE:
+		case JSON_TOKEN_NULL:
+			oHash.literal(nToken);
+			break;
+		default:
+			return false;
+		}
+	} while (!oHash.done());
+	return true;
+}
 
-// Helper: Compare two glz::generic values for equality
-static bool generic_equal(const glz::generic &a, const glz::generic &b)
+// Helper: Hash a parsed document (json_parse() handle)
+static void json_hash_tree(const json_value &value, json_structural_hash &oHash)
 {
-	// Check if same type
-	if (a.data.index() != b.data.index())
-	{
-		return false;
-	}
-
-	if (auto *obj_a = a.get_if<glz::generic::object_t>())
+	if (auto *obj = value.get_if<json_value::object_t>())
 	{
-		auto *obj_b = b.get_if<glz::generic::object_t>();
-		if (!obj_b || obj_a->size() != obj_b->size())
-			return false;
-		for (const auto &[key, val] : *obj_a)
+		oHash.begin(true);
+		for (const auto &[key, val] : *obj)
 		{
-			auto it = obj_b->find(key);
-			if (it == obj_b->end() || !generic_equal(val, it->second))
-				return false;
+			oHash.key(key);
+			json_hash_tree(val, oHash);
 		}
-		return true;
+		oHash.end();
 	}
-	else if (auto *arr_a = a.get_if<glz::generic::array_t>())
+	else if (auto *arr = value.get_if<json_value::array_t>())
 	{
-		auto *arr_b = b.get_if<glz::generic::array_t>();
-		if (!arr_b || arr_a->size() != arr_b->size())
-			return false;
-		for (size_t i = 0; i < arr_a->size(); ++i)
+		oHash.begin(false);
+		for (const auto &val : *arr)
 		{
-			if (!generic_equal((*arr_a)[i], (*arr_b)[i]))
-				return false;
+			json_hash_tree(val, oHash);
 		}
-		return true;
+		oHash.end();
 	}
-	else if (auto *str_a = a.get_if<std::string>())
+	else if (auto *str = value.get_if<json_value::string_t>())
 	{
-		auto *str_b = b.get_if<std::string>();
-		return str_b && *str_a == *str_b;
+		oHash.string(*str);
 	}
-	else if (auto *num_a = a.get_if<double>())
+	else if (auto *num = value.get_if<double>())
 	{
-		auto *num_b = b.get_if<double>();
-		return num_b && *num_a == *num_b;
+		oHash.number(*num);
 	}
-	else if (auto *bool_a = a.get_if<bool>())
+	else if (auto *flag = value.get_if<bool>())
 	{
-		auto *bool_b = b.get_if<bool>();
-		return bool_b && *bool_a == *bool_b;
+		oHash.literal(*flag ? JSON_TOKEN_TRUE : JSON_TOKEN_FALSE);
 	}
 	else
 	{
-		// Both are null
-		return true;
+		oHash.literal(JSON_TOKEN_NULL);
 	}
 }
 
-// Helper: Count elements in a glz::generic value
-static size_t generic_size(const glz::generic &value)
+// Helper: RFC 8785 key order (UTF-16 code units) for UTF-8 keys. Byte order
+// already matches code point order; the two only disagree when a character
+// above U+FFFF (surrogate pair) meets one in U+E000..U+FFFF.
+static bool json_utf16_less(std::string_view cLeft, std::string_view cRight)
 {
-	if (auto *obj = value.get_if<glz::generic::object_t>())
+	auto [itLeft, itRight] = std::mismatch(cLeft.begin(), cLeft.end(), cRight.begin(), cRight.end());
+	if (itLeft == cLeft.end() || itRight == cRight.end())
 	{
-		return obj->size();
+		return itLeft == cLeft.end() && itRight != cRight.end();
 	}
-	else if (auto *arr = value.get_if<glz::generic::array_t>())
+	unsigned char cA = static_cast<unsigned char>(*itLeft);
+	unsigned char cB = static_cast<unsigned char>(*itRight);
+	if (cA >= 0xEE && cB >= 0xEE && (cA >= 0xF0) != (cB >= 0xF0))
 	{
-		return arr->size();
+		return cA >= 0xF0;
 	}
-	return 1; // Scalar values count as 1
+	return cA < cB;
 }
 
-// Helper: Calculate max depth of a glz::generic value
-static size_t generic_depth(const glz::generic &value, size_t current = 0)
+// Helper: Shortest round-trip decimal digits of a positive finite number, as
+// aDigits[0..nDigits) with nValue = 0.d1d2...dk * 10^nExponent
+static void json_shortest_digits(double nValue, char *aDigits, int &nDigits, int &nExponent)
 {
-	if (auto *obj = value.get_if<glz::generic::object_t>())
-	{
-		size_t max_depth = current + 1;
-		for (const auto &[key, val] : *obj)
+	char aBuffer[40];
+#if defined(__cpp_lib_to_chars)
+	auto result = std::to_chars(aBuffer, aBuffer + sizeof(aBuffer) - 1, nValue, std::chars_format::scientific);
+	*result.ptr = '\0';
+#else
+	for (int nPrecision = 0; nPrecision < 17; nPrecision++)
+	{
+		snprintf(aBuffer, sizeof(aBuffer), "%.*e", nPrecision, nValue);
+		if (std::strtod(aBuffer, nullptr) == nValue)
 		{
-			max_depth = std::max(max_depth, generic_depth(val, current + 1));
+			break;
 		}
-		return max_depth;
 	}
-	else if (auto *arr = value.get_if<glz::generic::array_t>())
+#endif
+	const char *p = aBuffer;
+	nDigits = 0;
+	for (; *p && *p != 'e'; p++)
 	{
-		size_t max_depth = current + 1;
-		for (const auto &val : *arr)
+		if (json_is_digit(*p))
 		{
-			max_depth = std::max(max_depth, generic_depth(val, current + 1));
+			aDigits[nDigits++] = *p;
 		}
-		return max_depth;
 	}
-	return current;
+	while (nDigits > 1 && aDigits[nDigits - 1] == '0')
+	{
+		nDigits--;
+	}
+	nExponent = (*p == 'e' ? atoi(p + 1) : 0) + 1;
 }
 
-// Helper: Sort keys in a glz::generic object (recursively)
-static glz::generic generic_sort_keys(const glz::generic &value)
+// Helper: Write a number the way ECMAScript's Number.prototype.toString does,
+// as RFC 8785 requires
+static void json_write_es_number(std::string &cOut, double nValue)
 {
-	if (auto *obj = value.get_if<glz::generic::object_t>())
+	if (nValue == 0)
 	{
-		// Collect and sort keys
-		std::vector<std::string> keys;
-		keys.reserve(obj->size());
-		for (const auto &[key, val] : *obj)
+		cOut += '0';
+		return;
+	}
+	if (nValue < 0)
+	{
+		cOut += '-';
+		nValue = -nValue;
+	}
+
+	char aDigits[32];
+	int k, n;
+	json_shortest_digits(nValue, aDigits, k, n);
+	if (k <= n && n <= 21)
+	{
+		cOut.append(aDigits, k);
+		cOut.append(n - k, '0');
+	}
+	else if (0 < n && n <= 21)
+	{
+		cOut.append(aDigits, n);
+		cOut += '.';
+		cOut.append(aDigits + n, k - n);
+	}
+	else if (-6 < n && n <= 0)
+	{
+		cOut += "0.";
+		cOut.append(-n, '0');
+		cOut.append(aDigits, k);
+	}
+	else
+	{
+		cOut += aDigits[0];
+		if (k > 1)
 		{
-			keys.push_back(key);
+			cOut += '.';
+			cOut.append(aDigits + 1, k - 1);
 		}
-		std::sort(keys.begin(), keys.end());
+		cOut += n - 1 < 0 ? "e-" : "e+";
+		cOut += std::to_string(std::abs(n - 1));
+	}
+}
+
+// Writes JSON text as RFC 8785 (JCS) canonical JSON in one pass over its
+// tokens. Arrays and scalars are written straight through; only the members of
+// each open object are buffered (already canonical) until its end, when they
+// are emitted in key order. Buffers are kept per depth and reused.
+class json_canonical_writer
+{
+  public:
+	const char *cError = nullptr;
 
-		// Build new sorted object
-		glz::generic::object_t sorted_obj;
-		for (const auto &key : keys)
+	bool write(std::string_view json, std::string &cOut)
+	{
+		json_reader oReader(json.data(), json.data() + json.size());
+		oReader.bCheckUtf8 = true;
+		pRoot = &cOut;
+		nDepth = 0;
+		do
 		{
-			sorted_obj[key] = generic_sort_keys(obj->at(key));
+			if (!step(oReader))
+			{
+				return false;
+			}
+		} while (nDepth > 0);
+		if (!oReader.finish())
+		{
+			cError = "Invalid JSON input.";
+			return false;
 		}
+		return true;
+	}
+
+  private:
+	struct member
+	{
+		size_t nKey;	 // unescaped key in level::cKeys
+		size_t nKeySize;
+		size_t nStart;	 // "key":value in level::cBody, up to the next member
+	};
+
+	struct level
+	{
+		bool bObject;
+		bool bFirst;
+		std::string *pOut; // where values at this level are written
+		std::string cBody;
+		std::string cKeys;
+		std::vector<member> aMembers;
+	};
+
+	std::deque<level> aLevels; // deque: pOut may point into an outer level
+	size_t nDepth = 0;
+	std::string *pRoot = nullptr;
+	std::string cScratch;
+	std::vector<size_t> aOrder;
 
-		glz::generic result;
-		result.data = std::move(sorted_obj);
-		return result;
+	std::string &out()
+	{
+		return nDepth ? *aLevels[nDepth - 1].pOut : *pRoot;
 	}
-	else if (auto *arr = value.get_if<glz::generic::array_t>())
+
+	std::string &begin_value()
 	{
-		glz::generic::array_t sorted_arr;
-		sorted_arr.reserve(arr->size());
-		for (const auto &val : *arr)
+		if (nDepth && !aLevels[nDepth - 1].bObject)
 		{
-			sorted_arr.push_back(generic_sort_keys(val));
+			level &oLevel = aLevels[nDepth - 1];
+			if (!oLevel.bFirst)
+			{
+				*oLevel.pOut += ',';
+			}
+			oLevel.bFirst = false;
+		}
+		return out();
+	}
+
+	void push(bool bObject)
+	{
+		std::string &cParent = out();
+		if (nDepth == aLevels.size())
+		{
+			aLevels.emplace_back();
+		}
+		level &oLevel = aLevels[nDepth++];
+		oLevel.bObject = bObject;
+		oLevel.bFirst = true;
+		oLevel.pOut = bObject ? &oLevel.cBody : &cParent;
+		oLevel.cBody.clear();
+		oLevel.cKeys.clear();
+		oLevel.aMembers.clear();
+	}
+
+	bool close_object()
+	{
+		level &oLevel = aLevels[nDepth - 1];
+		auto fnKey = [&](size_t i) {
+			return std::string_view(oLevel.cKeys).substr(oLevel.aMembers[i].nKey, oLevel.aMembers[i].nKeySize);
+		};
+		aOrder.resize(oLevel.aMembers.size());
+		for (size_t i = 0; i < aOrder.size(); i++)
+		{
+			aOrder[i] = i;
+		}
+		std::sort(aOrder.begin(), aOrder.end(), [&](size_t a, size_t b) { return json_utf16_less(fnKey(a), fnKey(b)); });
+
+		nDepth--;
+		std::string &cOut = out();
+		cOut += '{';
+		for (size_t i = 0; i < aOrder.size(); i++)
+		{
+			if (i > 0)
+			{
+				if (fnKey(aOrder[i - 1]) == fnKey(aOrder[i]))
+				{
+					cError = "Duplicate object key in JSON input.";
+					return false;
+				}
+				cOut += ',';
+			}
+			size_t nMember = aOrder[i];
+			size_t nStart = oLevel.aMembers[nMember].nStart;
+			size_t nEnd =
+				nMember + 1 < oLevel.aMembers.size() ? oLevel.aMembers[nMember + 1].nStart : oLevel.cBody.size();
+			cOut.append(oLevel.cBody, nStart, nEnd - nStart);
 		}
+		cOut += '}';
+		return true;
+	}
 
-		glz::generic result;
-		result.data = std::move(sorted_arr);
-		return result;
+	std::string_view unescaped(const json_reader &oReader)
+	{
+		if (!oReader.bEscaped)
+		{
+			return oReader.text();
+		}
+		json_unescape(oReader.text(), cScratch);
+		return cScratch;
 	}
 
-	return value;
-}
+	bool step(json_reader &oReader)
+	{
+		json_token nToken = oReader.next();
+		switch (nToken)
+		{
+		case JSON_TOKEN_OBJECT_BEGIN:
+			begin_value();
+			push(true);
+			return true;
+		case JSON_TOKEN_ARRAY_BEGIN:
+			begin_value() += '[';
+			push(false);
+			return true;
+		case JSON_TOKEN_OBJECT_END:
+			return close_object();
+		case JSON_TOKEN_ARRAY_END:
+			nDepth--;
+			out() += ']';
+			return true;
+		case JSON_TOKEN_KEY: {
+			level &oLevel = aLevels[nDepth - 1];
+			std::string_view cKey = unescaped(oReader);
+			oLevel.aMembers.push_back({oLevel.cKeys.size(), cKey.size(), oLevel.cBody.size()});
+			oLevel.cKeys += cKey;
+			json_write_string(oLevel.cBody, cKey.data(), cKey.size());
+			oLevel.cBody += ':';
+			return true;
+		}
+		case JSON_TOKEN_STRING: {
+			std::string &cOut = begin_value();
+			std::string_view cText = unescaped(oReader);
+			json_write_string(cOut, cText.data(), cText.size());
+			return true;
+		}
+		case JSON_TOKEN_NUMBER: {
+			double nValue = oReader.number();
+			if (!std::isfinite(nValue))
+			{
+				cError = "Number out of range in JSON input.";
+				return false;
+			}
+			json_write_es_number(begin_value(), nValue);
+			return true;
+		}
+		case JSON_TOKEN_TRUE:
+			begin_value() += "true";
+			return true;
+		case JSON_TOKEN_FALSE:
+			begin_value() += "false";
+			return true;
+		case JSON_TOKEN_NULL:
+			begin_value() += "null";
+			return true;
+		default:
+			cError = "Invalid JSON input.";
+			return false;
+		}
+	}
+};
 
 RING_FUNC(ring_json_equal)
 {
@@ -1376,29 +6145,10 @@ RING_FUNC(ring_json_equal)
 		return;
 	}
 
-	const char *cJson1 = RING_API_GETSTRING(1);
-	const char *cJson2 = RING_API_GETSTRING(2);
-
-	glz::generic json1, json2;
-
-	auto ec1 = glz::read_json(json1, std::string_view(cJson1));
-	if (ec1)
-	{
-		RING_API_RETNUMBER(0.0);
-		return;
-	}
-
-	auto ec2 = glz::read_json(json2, std::string_view(cJson2));
-	if (ec2)
-	{
-		RING_API_RETNUMBER(0.0);
-		return;
-	}
-
-	RING_API_RETNUMBER(generic_equal(json1, json2) ? 1.0 : 0.0);
+	RING_API_RETNUMBER(json_equal_text(JSON_STRING_PARAM(1), JSON_STRING_PARAM(2)) ? 1.0 : 0.0);
 }
 
-RING_FUNC(ring_json_size)
+RING_FUNC(ring_json_hash)
 {
 	if (RING_API_PARACOUNT != 1)
 	{
@@ -1406,27 +6156,57 @@ RING_FUNC(ring_json_size)
 		return;
 	}
 
-	if (!RING_API_ISSTRING(1))
+	json_structural_hash oHash;
+	if (RING_API_ISCPOINTER(1))
 	{
-		RING_API_ERROR(RING_API_BADPARATYPE);
-		return;
+		const json_value *pRoot = json_document_param(pPointer, 1);
+		if (!pRoot)
+		{
+			return;
+		}
+		json_hash_tree(*pRoot, oHash);
 	}
-
-	const char *cJsonString = RING_API_GETSTRING(1);
-	std::string_view jsonView(cJsonString);
-
-	glz::generic jsonRoot;
-	auto ec = glz::read_json(jsonRoot, jsonView);
-	if (ec)
+	else if (RING_API_ISSTRING(1))
 	{
-		RING_API_ERROR("Invalid JSON input.");
+		std::string_view jsonView = JSON_STRING_PARAM(1);
+		json_reader oReader(jsonView.data(), jsonView.data() + jsonView.size());
+		if (!json_hash_tokens(oReader, oHash) || !oReader.finish())
+		{
+			RING_API_ERROR("Invalid JSON input.");
+			return;
+		}
+	}
+	else if (RING_API_ISLIST(1))
+	{
+		// Hash the list as json_encode() would write it, without encoding
+		json_tape oTape;
+		std::vector<List *> aAncestors;
+		json_tape_record_list(oTape, RING_API_GETLIST(1), aAncestors);
+		json_tape_reader oReader(oTape);
+		json_hash_tokens(oReader, oHash);
+	}
+	else
+	{
+		RING_API_ERROR(RING_API_BADPARATYPE);
 		return;
 	}
 
-	RING_API_RETNUMBER(static_cast<double>(generic_size(jsonRoot)));
+	char cHex[17];
+	snprintf(cHex, sizeof(cHex), "%016llx", static_cast<unsigned long long>(oHash.result()));
+	RING_API_RETSTRING2(cHex, 16);
+}
+
+RING_FUNC(ring_json_size)
+{
+	json_measure_param(pPointer, JSON_MEASURE_SIZE);
 }
 
 RING_FUNC(ring_json_depth)
+{
+	json_measure_param(pPointer, JSON_MEASURE_DEPTH);
+}
+
+RING_FUNC(ring_json_sort_keys)
 {
 	if (RING_API_PARACOUNT != 1)
 	{
@@ -1440,21 +6220,27 @@ RING_FUNC(ring_json_depth)
 		return;
 	}
 
-	const char *cJsonString = RING_API_GETSTRING(1);
-	std::string_view jsonView(cJsonString);
+	std::string_view jsonView = JSON_STRING_PARAM(1);
 
-	glz::generic jsonRoot;
-	auto ec = glz::read_json(jsonRoot, jsonView);
-	if (ec)
+	json_tree_arena oArena;
+	json_value jsonRoot(oArena.resource());
+	std::string cError;
+	if (!json_tree_load(jsonView, jsonRoot, cError))
 	{
 		RING_API_ERROR("Invalid JSON input.");
 		return;
 	}
 
-	RING_API_RETNUMBER(static_cast<double>(generic_depth(jsonRoot)));
+	json_tree_sort_keys(jsonRoot);
+
+	json_output_buffer oOutput;
+	std::string &result = oOutput.str();
+	json_tree_write(result, jsonRoot);
+
+	RING_API_RETSTRING2(result.data(), result.size());
 }
 
-RING_FUNC(ring_json_sort_keys)
+RING_FUNC(ring_json_canonicalize)
 {
 	if (RING_API_PARACOUNT != 1)
 	{
@@ -1468,28 +6254,16 @@ RING_FUNC(ring_json_sort_keys)
 		return;
 	}
 
-	const char *cJsonString = RING_API_GETSTRING(1);
-	std::string_view jsonView(cJsonString);
-
-	glz::generic jsonRoot;
-	auto ec = glz::read_json(jsonRoot, jsonView);
-	if (ec)
-	{
-		RING_API_ERROR("Invalid JSON input.");
-		return;
-	}
-
-	glz::generic sorted = generic_sort_keys(jsonRoot);
-
-	std::string result;
-	auto ec2 = glz::write_json(sorted, result);
-	if (ec2)
+	json_canonical_writer oWriter;
+	json_output_buffer oOutput;
+	std::string &result = oOutput.str();
+	if (!oWriter.write(JSON_STRING_PARAM(1), result))
 	{
-		RING_API_ERROR("Failed to serialize sorted JSON.");
+		RING_API_ERROR(oWriter.cError);
 		return;
 	}
 
-	RING_API_RETSTRING(result.c_str());
+	RING_API_RETSTRING2(result.data(), result.size());
 }
 
 // ============================================================================
@@ -1510,11 +6284,8 @@ RING_FUNC(ring_base64_encode)
 		return;
 	}
 
-	const char *cData = RING_API_GETSTRING(1);
-	int nSize = RING_API_GETSTRINGSIZE(1);
-
-	std::string encoded = glz::write_base64(std::string_view(cData, nSize));
-	RING_API_RETSTRING(encoded.c_str());
+	std::string encoded = glz::write_base64(JSON_STRING_PARAM(1));
+	RING_API_RETSTRING2(encoded.data(), encoded.size());
 }
 
 RING_FUNC(ring_base64_decode)
@@ -1531,9 +6302,8 @@ RING_FUNC(ring_base64_decode)
 		return;
 	}
 
-	const char *cEncoded = RING_API_GETSTRING(1);
-	std::string decoded = glz::read_base64(std::string_view(cEncoded));
-	RING_API_RETSTRING2(decoded.c_str(), decoded.size());
+	std::string decoded = glz::read_base64(JSON_STRING_PARAM(1));
+	RING_API_RETSTRING2(decoded.data(), decoded.size());
 }
 
 // ============================================================================
@@ -1554,8 +6324,7 @@ RING_FUNC(ring_json_strip_comments)
 		return;
 	}
 
-	const char *cJsonString = RING_API_GETSTRING(1);
-	std::string input(cJsonString);
+	std::string_view input = JSON_STRING_PARAM(1);
 
 	// Parse with comments enabled
 	glz::generic jsonRoot;
@@ -1568,7 +6337,8 @@ RING_FUNC(ring_json_strip_comments)
 	}
 
 	// Write back as standard JSON (comments stripped)
-	std::string result;
+	json_output_buffer oOutput;
+	std::string &result = oOutput.str();
 	auto ec2 = glz::write_json(jsonRoot, result);
 	if (ec2)
 	{
@@ -1576,7 +6346,7 @@ RING_FUNC(ring_json_strip_comments)
 		return;
 	}
 
-	RING_API_RETSTRING(result.c_str());
+	RING_API_RETSTRING2(result.data(), result.size());
 }
 
 // ============================================================================
@@ -1591,91 +6361,160 @@ RING_FUNC(ring_json_query)
 		return;
 	}
 
-	if (!RING_API_ISSTRING(1) || !RING_API_ISSTRING(2))
+	if ((!RING_API_ISSTRING(1) && !RING_API_ISCPOINTER(1)) || !RING_API_ISSTRING(2))
 	{
 		RING_API_ERROR(RING_API_BADPARATYPE);
 		return;
 	}
 
-	const char *cJsonString = RING_API_GETSTRING(1);
-	const char *cQuery = RING_API_GETSTRING(2);
+	std::vector<std::string> tokens = json_query_tokens(JSON_STRING_PARAM(2));
 
-	std::string_view jsonView(cJsonString);
+	json_output_buffer oOutput;
+	std::string &result = oOutput.str();
 
-	glz::generic jsonRoot;
-	auto ec = glz::read_json(jsonRoot, jsonView);
-	if (ec)
+	if (RING_API_ISCPOINTER(1))
 	{
-		RING_API_ERROR("Invalid JSON input.");
-		return;
+		json_value *pDocument = json_document_param(pPointer, 1);
+		if (!pDocument)
+		{
+			return;
+		}
+		const json_value *pValue = nullptr;
+		if (json_tree_seek(*pDocument, tokens, pValue) != JSON_SEEK_FOUND)
+		{
+			RING_API_RETSTRING("null");
+			return;
+		}
+		json_tree_write(result, *pValue);
+	}
+	else
+	{
+		// The whole document must be valid, not only the path to the value
+		std::string_view jsonView = JSON_STRING_PARAM(1);
+		json_reader oCheck(jsonView.data(), jsonView.data() + jsonView.size());
+		if (!oCheck.skip_value() || !oCheck.finish())
+		{
+			RING_API_ERROR("Invalid JSON input.");
+			return;
+		}
+		json_reader oReader(jsonView.data(), jsonView.data() + jsonView.size());
+		json_seek_result nResult = json_reader_seek(oReader, tokens);
+		if (nResult == JSON_SEEK_FOUND && !json_reader_copy_value(oReader, result))
+		{
+			nResult = JSON_SEEK_INVALID;
+		}
+		if (nResult == JSON_SEEK_INVALID)
+		{
+			RING_API_ERROR("Invalid JSON input.");
+			return;
+		}
+		if (nResult != JSON_SEEK_FOUND)
+		{
+			RING_API_RETSTRING("null");
+			return;
+		}
 	}
 
-	std::string query(cQuery);
-	glz::generic *current = &jsonRoot;
+	RING_API_RETSTRING2(result.data(), result.size());
+}
+
+// ============================================================================
+// JMESPath
+// ============================================================================
+
+constexpr size_t JSON_JMESPATH_CACHE_SIZE = 64;
 
-	if (!query.empty() && query[0] == '/')
+// Most recently used compiled expressions, so hot queries are not reparsed.
+// glz::jmespath_expression keeps a view of its text, which therefore lives in
+// the cache entry next to it. Expressions that fail to compile are not cached.
+struct json_jmespath_cache
+{
+	struct entry
+	{
+		std::string cExpression;
+		glz::jmespath_expression oCompiled;
+
+		explicit entry(std::string_view cText) : cExpression(cText), oCompiled(std::string_view(cExpression))
+		{
+		}
+	};
+
+	std::list<entry> aEntries; // front is the most recently used
+	std::unordered_map<std::string_view, std::list<entry>::iterator> mIndex;
+
+	// Returns NULL when cText is not a valid expression
+	const glz::jmespath_expression *get(std::string_view cText)
 	{
-		query = query.substr(1);
+		auto it = mIndex.find(cText);
+		if (it != mIndex.end())
+		{
+			aEntries.splice(aEntries.begin(), aEntries, it->second);
+			return &it->second->oCompiled;
+		}
+		aEntries.emplace_front(cText);
+		if (aEntries.front().oCompiled.error != glz::jmespath::tokenization_error::none)
+		{
+			aEntries.pop_front();
+			return nullptr;
+		}
+		if (aEntries.size() > JSON_JMESPATH_CACHE_SIZE)
+		{
+			mIndex.erase(aEntries.back().cExpression);
+			aEntries.pop_back();
+		}
+		mIndex.emplace(aEntries.front().cExpression, aEntries.begin());
+		return &aEntries.front().oCompiled;
 	}
+};
 
-	std::vector<std::string> tokens;
-	size_t pos = 0;
-	while ((pos = query.find('/')) != std::string::npos)
+RING_FUNC(ring_json_jmespath)
+{
+	if (RING_API_PARACOUNT != 2)
 	{
-		tokens.push_back(query.substr(0, pos));
-		query.erase(0, pos + 1);
+		RING_API_ERROR(RING_API_MISS2PARA);
+		return;
 	}
-	if (!query.empty())
+
+	if (!RING_API_ISSTRING(1) || !RING_API_ISSTRING(2))
 	{
-		tokens.push_back(query);
+		RING_API_ERROR(RING_API_BADPARATYPE);
+		return;
 	}
 
-	for (const auto &token : tokens)
+	static thread_local json_jmespath_cache oCache;
+
+	std::string_view jsonView = JSON_STRING_PARAM(1);
+	const glz::jmespath_expression *pExpression = oCache.get(JSON_STRING_PARAM(2));
+	if (!pExpression)
 	{
-		if (auto *obj = current->get_if<glz::generic::object_t>())
-		{
-			auto it = obj->find(token);
-			if (it == obj->end())
-			{
-				RING_API_RETSTRING("null");
-				return;
-			}
-			current = &(it->second);
-		}
-		else if (auto *arr = current->get_if<glz::generic::array_t>())
-		{
-			try
-			{
-				size_t index = std::stoull(token);
-				if (index >= arr->size())
-				{
-					RING_API_RETSTRING("null");
-					return;
-				}
-				current = &((*arr)[index]);
-			}
-			catch (...)
-			{
-				RING_API_RETSTRING("null");
-				return;
-			}
-		}
-		else
+		RING_API_ERROR("Invalid JMESPath expression.");
+		return;
+	}
+
+	glz::generic value;
+	json_output_buffer oOutput;
+	std::string &result = oOutput.str();
+	auto ec = glz::read_jmespath(*pExpression, value, jsonView);
+	if (ec)
+	{
+		// A query that selects nothing is null, but malformed JSON is an error
+		json_reader oReader(jsonView.data(), jsonView.data() + jsonView.size());
+		if (!oReader.skip_value() || !oReader.finish())
 		{
-			RING_API_RETSTRING("null");
+			RING_API_ERROR("Invalid JSON input.");
 			return;
 		}
+		RING_API_RETSTRING("null");
+		return;
 	}
 
-	std::string result;
-	auto ec2 = glz::write_json(*current, result);
-	if (ec2)
+	if (glz::write_json(value, result))
 	{
-		RING_API_RETSTRING("null");
+		RING_API_ERROR("Failed to serialize JSON.");
 		return;
 	}
 
-	RING_API_RETSTRING(result.c_str());
+	RING_API_RETSTRING2(result.data(), result.size());
 }
 
 // ============================================================================
@@ -1696,16 +6535,21 @@ RING_FUNC(ring_csv_to_json)
 		return;
 	}
 
-	const char *cCsvString = RING_API_GETSTRING(1);
-	std::string csvInput(cCsvString);
+	std::string_view csvInput = JSON_STRING_PARAM(1);
 
 	// Parse CSV into vector of vectors (rows of values)
 	std::vector<std::vector<std::string>> rows;
-	std::istringstream stream(csvInput);
-	std::string line;
+	size_t nLineStart = 0;
 
-	while (std::getline(stream, line))
+	while (nLineStart < csvInput.size())
 	{
+		size_t nLineEnd = csvInput.find('\n', nLineStart);
+		if (nLineEnd == std::string_view::npos)
+		{
+			nLineEnd = csvInput.size();
+		}
+		std::string_view line = csvInput.substr(nLineStart, nLineEnd - nLineStart);
+		nLineStart = nLineEnd + 1;
 		if (line.empty())
 			continue;
 
@@ -1731,7 +6575,7 @@ RING_FUNC(ring_csv_to_json)
 			}
 		}
 		row.push_back(cell);
-		rows.push_back(row);
+		rows.push_back(std::move(row));
 	}
 
 	if (rows.empty())
@@ -1743,16 +6587,19 @@ RING_FUNC(ring_csv_to_json)
 	// First row is headers
 	std::vector<std::string> headers = rows[0];
 
-	// Build JSON array of objects
-	glz::generic::array_t jsonArray;
+	// Build JSON array of objects, with members in column order
+	json_tree_arena oArena;
+	json_value result(oArena.resource());
+	auto &jsonArray = result.make_array();
+	jsonArray.reserve(rows.size() - 1);
 
 	for (size_t i = 1; i < rows.size(); ++i)
 	{
-		glz::generic::object_t obj;
+		auto &obj = jsonArray.emplace_back().make_object();
 		for (size_t j = 0; j < headers.size() && j < rows[i].size(); ++j)
 		{
 			const std::string &val = rows[i][j];
-			glz::generic cellValue;
+			json_value &cellValue = obj[headers[j]];
 
 			try
 			{
@@ -1764,32 +6611,21 @@ RING_FUNC(ring_csv_to_json)
 				}
 				else
 				{
-					cellValue.data = val;
+					cellValue.set_string(val);
 				}
 			}
 			catch (...)
 			{
-				cellValue.data = val;
+				cellValue.set_string(val);
 			}
-			obj[headers[j]] = std::move(cellValue);
 		}
-		glz::generic rowObj;
-		rowObj.data = std::move(obj);
-		jsonArray.push_back(std::move(rowObj));
 	}
 
-	glz::generic result;
-	result.data = std::move(jsonArray);
-
-	std::string jsonOutput;
-	auto ec = glz::write_json(result, jsonOutput);
-	if (ec)
-	{
-		RING_API_ERROR("Failed to serialize JSON.");
-		return;
-	}
+	json_output_buffer oOutput;
+	std::string &jsonOutput = oOutput.str();
+	json_tree_write(jsonOutput, result);
 
-	RING_API_RETSTRING(jsonOutput.c_str());
+	RING_API_RETSTRING2(jsonOutput.data(), jsonOutput.size());
 }
 
 RING_FUNC(ring_json_to_csv)
@@ -1806,26 +6642,26 @@ RING_FUNC(ring_json_to_csv)
 		return;
 	}
 
-	const char *cJsonString = RING_API_GETSTRING(1);
-	std::string_view jsonView(cJsonString);
+	std::string_view jsonView = JSON_STRING_PARAM(1);
 
-	glz::generic jsonRoot;
-	auto ec = glz::read_json(jsonRoot, jsonView);
-	if (ec)
+	json_tree_arena oArena;
+	json_value jsonRoot(oArena.resource());
+	std::string cError;
+	if (!json_tree_load(jsonView, jsonRoot, cError))
 	{
 		RING_API_ERROR("Invalid JSON input.");
 		return;
 	}
 
-	auto *arr = jsonRoot.get_if<glz::generic::array_t>();
+	auto *arr = jsonRoot.get_if<json_value::array_t>();
 	if (!arr || arr->empty())
 	{
 		RING_API_ERROR("JSON must be a non-empty array of objects.");
 		return;
 	}
 
-	// Get headers from first object
-	auto *firstObj = (*arr)[0].get_if<glz::generic::object_t>();
+	// Get headers from first object, in document order
+	auto *firstObj = (*arr)[0].get_if<json_value::object_t>();
 	if (!firstObj)
 	{
 		RING_API_ERROR("JSON array must contain objects.");
@@ -1835,9 +6671,8 @@ RING_FUNC(ring_json_to_csv)
 	std::vector<std::string> headers;
 	for (const auto &[key, val] : *firstObj)
 	{
-		headers.push_back(key);
+		headers.emplace_back(key);
 	}
-	std::sort(headers.begin(), headers.end());
 
 	std::ostringstream csv;
 
@@ -1853,7 +6688,7 @@ RING_FUNC(ring_json_to_csv)
 	// Write rows
 	for (const auto &item : *arr)
 	{
-		auto *obj = item.get_if<glz::generic::object_t>();
+		auto *obj = item.get_if<json_value::object_t>();
 		if (!obj)
 			continue;
 
@@ -1866,7 +6701,7 @@ RING_FUNC(ring_json_to_csv)
 			if (it != obj->end())
 			{
 				const auto &val = it->second;
-				if (auto *str = val.get_if<std::string>())
+				if (auto *str = val.get_if<json_value::string_t>())
 				{
 					// Escape quotes and wrap in quotes if contains comma
 					if (str->find(',') != std::string::npos || str->find('"') != std::string::npos)
@@ -1900,7 +6735,8 @@ RING_FUNC(ring_json_to_csv)
 		csv << "\n";
 	}
 
-	RING_API_RETSTRING(csv.str().c_str());
+	std::string csvOutput = csv.str();
+	RING_API_RETSTRING2(csvOutput.data(), csvOutput.size());
 }
 
 // ============================================================================
@@ -1921,8 +6757,7 @@ RING_FUNC(ring_toml_to_json)
 		return;
 	}
 
-	const char *cTomlString = RING_API_GETSTRING(1);
-	std::string tomlInput(cTomlString);
+	std::string_view tomlInput = JSON_STRING_PARAM(1);
 
 	glz::generic tomlRoot;
 	auto ec = glz::read<glz::opts{.format = glz::TOML}>(tomlRoot, tomlInput);
@@ -1933,7 +6768,8 @@ RING_FUNC(ring_toml_to_json)
 		return;
 	}
 
-	std::string jsonOutput;
+	json_output_buffer oOutput;
+	std::string &jsonOutput = oOutput.str();
 	auto ec2 = glz::write_json(tomlRoot, jsonOutput);
 	if (ec2)
 	{
@@ -1941,7 +6777,7 @@ RING_FUNC(ring_toml_to_json)
 		return;
 	}
 
-	RING_API_RETSTRING(jsonOutput.c_str());
+	RING_API_RETSTRING2(jsonOutput.data(), jsonOutput.size());
 }
 
 RING_FUNC(ring_json_to_toml)
@@ -1958,8 +6794,7 @@ RING_FUNC(ring_json_to_toml)
 		return;
 	}
 
-	const char *cJsonString = RING_API_GETSTRING(1);
-	std::string_view jsonView(cJsonString);
+	std::string_view jsonView = JSON_STRING_PARAM(1);
 
 	glz::generic jsonRoot;
 	auto ec = glz::read_json(jsonRoot, jsonView);
@@ -1969,7 +6804,8 @@ RING_FUNC(ring_json_to_toml)
 		return;
 	}
 
-	std::string tomlOutput;
+	json_output_buffer oOutput;
+	std::string &tomlOutput = oOutput.str();
 	auto ec2 = glz::write<glz::opts{.format = glz::TOML}>(jsonRoot, tomlOutput);
 	if (ec2)
 	{
@@ -1977,23 +6813,30 @@ RING_FUNC(ring_json_to_toml)
 		return;
 	}
 
-	RING_API_RETSTRING(tomlOutput.c_str());
+	RING_API_RETSTRING2(tomlOutput.data(), tomlOutput.size());
 }
 
 RING_LIBINIT
 {
 	RING_API_REGISTER("json_decode", ring_json_decode);
 	RING_API_REGISTER("json_encode", ring_json_encode);
+	RING_API_REGISTER("json_shape_compile", ring_json_shape_compile);
 	RING_API_REGISTER("json_version", ring_json_version);
 	RING_API_REGISTER("json_true", ring_json_true);
 	RING_API_REGISTER("json_false", ring_json_false);
+	RING_API_REGISTER("json_null", ring_json_null);
+	RING_API_REGISTER("json_empty_object", ring_json_empty_object);
 	RING_API_REGISTER("json_is_true", ring_json_is_true);
 	RING_API_REGISTER("json_is_false", ring_json_is_false);
 	RING_API_REGISTER("json_tobool", ring_json_tobool);
 	RING_API_REGISTER("json_valid", ring_json_valid);
+	RING_API_REGISTER("json_valid_many", ring_json_valid_many);
 	RING_API_REGISTER("json_minify", ring_json_minify);
 	RING_API_REGISTER("json_prettify", ring_json_prettify);
+	RING_API_REGISTER("json_parse", ring_json_parse);
+	RING_API_REGISTER("json_free", ring_json_free);
 	RING_API_REGISTER("json_pointer", ring_json_pointer);
+	RING_API_REGISTER("json_pointer_many", ring_json_pointer_many);
 	RING_API_REGISTER("json_type", ring_json_type);
 	RING_API_REGISTER("json_keys", ring_json_keys);
 	RING_API_REGISTER("json_has", ring_json_has);
@@ -2010,14 +6853,20 @@ RING_LIBINIT
 	RING_API_REGISTER("cbor_to_json", ring_cbor_to_json);
 	RING_API_REGISTER("json_ndjson_encode", ring_json_ndjson_encode);
 	RING_API_REGISTER("json_ndjson_decode", ring_json_ndjson_decode);
+	RING_API_REGISTER("json_ndjson_open", ring_json_ndjson_open);
+	RING_API_REGISTER("json_ndjson_next", ring_json_ndjson_next);
+	RING_API_REGISTER("json_ndjson_close", ring_json_ndjson_close);
 	RING_API_REGISTER("json_equal", ring_json_equal);
+	RING_API_REGISTER("json_hash", ring_json_hash);
 	RING_API_REGISTER("json_size", ring_json_size);
 	RING_API_REGISTER("json_depth", ring_json_depth);
 	RING_API_REGISTER("json_sort_keys", ring_json_sort_keys);
+	RING_API_REGISTER("json_canonicalize", ring_json_canonicalize);
 	RING_API_REGISTER("base64_encode", ring_base64_encode);
 	RING_API_REGISTER("base64_decode", ring_base64_decode);
 	RING_API_REGISTER("json_strip_comments", ring_json_strip_comments);
 	RING_API_REGISTER("json_query", ring_json_query);
+	RING_API_REGISTER("json_jmespath", ring_json_jmespath);
 	RING_API_REGISTER("csv_to_json", ring_csv_to_json);
 	RING_API_REGISTER("json_to_csv", ring_json_to_csv);
 	RING_API_REGISTER("toml_to_json", ring_toml_to_json);